@@ -0,0 +1,140 @@
+//
+//  BenchExpression.cc
+//  archetype
+//
+//
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BenchExpression.hh"
+#include "BenchRegistry.hh"
+#include "Expression.hh"
+#include "Universe.hh"
+#include "SourceFile.hh"
+#include "TokenStream.hh"
+
+using namespace std;
+
+namespace archetype {
+    ARCHETYPE_BENCH_REGISTER(BenchExpression);
+
+    static char program_operands[] =
+    "null box\n"
+    "  n: 12\n"
+    "  s: \"brass lamp\"\n"
+    "  l: UNDEFINED\n"
+    "end\n"
+    ;
+
+    void BenchExpression::benchCompare_() {
+        Value twelve{new NumericValue{12}};
+        Value five{new NumericValue{5}};
+        Value numeral{new StringValue{"12"}};
+        Value brass{new StringValue{"brass lamp"}};
+        Value wooden{new StringValue{"wooden table"}};
+        Value message;
+        Value other_message;
+        Value box{new ObjectValue{1}};
+        Value table{new ObjectValue{2}};
+
+        vector<pair<string, function<void()>>> comparisons = {
+            {"eval_compare/number<number", [&] { eval_compare(Keywords::OP_LT, twelve, five); }},
+            {"eval_compare/number=number", [&] { eval_compare(Keywords::OP_EQ, twelve, five); }},
+            {"eval_compare/string=string", [&] { eval_compare(Keywords::OP_EQ, brass, wooden); }},
+            {"eval_compare/string<string", [&] { eval_compare(Keywords::OP_LT, brass, wooden); }},
+            {"eval_compare/number=string", [&] { eval_compare(Keywords::OP_EQ, twelve, numeral); }},
+            {"eval_compare/message=string", [&] { eval_compare(Keywords::OP_EQ, message, brass); }},
+            {"eval_compare/message=message", [&] { eval_compare(Keywords::OP_EQ, message, other_message); }},
+            {"eval_compare/object=object", [&] { eval_compare(Keywords::OP_EQ, box, table); }}
+        };
+        if (none_of(comparisons.begin(), comparisons.end(),
+                    [&](const pair<string, function<void()>>& c) { return wanted_(c.first); })) {
+            return;
+        }
+        Universe::destroy();
+        message = Value{new MessageValue{Universe::instance().Messages.index("brass lamp")}};
+        other_message = Value{new MessageValue{Universe::instance().Messages.index("wooden table")}};
+        for (auto const& c : comparisons) {
+            measure_(c.first, c.second);
+        }
+    }
+
+    static void make_operands() {
+        Universe::destroy();
+        TokenStream t(make_source_from_str("operands", program_operands));
+        if (not Universe::instance().make(t)) {
+            throw logic_error("Could not compile the operands for BenchExpression");
+        }
+    }
+
+    void BenchExpression::benchBinaryOperators_() {
+        // One expression for each class of binary operator.
+        vector<pair<string, string>> expressions = {
+            {"arithmetic", "12 * 5 + 3"},
+            {"power", "2 ^ 10"},
+            {"concatenation", "\"brass\" & \" lamp\""},
+            {"substring", "\"brass lamp\" leftfrom 7"},
+            {"within", "\"lamp\" within \"brass lamp\""},
+            {"comparison", "12 < 5"},
+            {"logical", "TRUE and FALSE"},
+            {"pair", "12 @ 5"},
+            {"dot", "box.n"},
+            {"assignment", "box.l := 12"},
+            {"cumulative", "box.s &:= \"\""}
+        };
+        if (none_of(expressions.begin(), expressions.end(),
+                    [&](const pair<string, string>& e) { return wanted_("BinaryOperator/" + e.first); })) {
+            return;
+        }
+        make_operands();
+        for (auto const& e : expressions) {
+            if (not wanted_("BinaryOperator/" + e.first)) {
+                continue;
+            }
+            Expression expr = make_expr_from_str(e.second);
+            if (not expr) {
+                throw logic_error("Could not compile \"" + e.second + "\"");
+            }
+            measure_("BinaryOperator/" + e.first, [&] { Value v = expr->evaluate(); });
+        }
+    }
+
+    // Building up a long string a piece at a time, as a game's lexer or
+    // transcript would.  Each sample starts again from an empty string.
+    void BenchExpression::benchAccumulation_() {
+        vector<pair<string, string>> expressions = {
+            {"cumulative", "box.s &:= \" word\""},
+            {"concatenation", "box.s := box.s & \" word\""}
+        };
+        Expression reset;
+        for (auto const& e : expressions) {
+            for (int pieces : {1000, 10000}) {
+                string name = "accumulate/" + e.first + "/" + to_string(pieces);
+                if (not wanted_(name)) {
+                    continue;
+                }
+                if (not reset) {
+                    make_operands();
+                    reset = make_expr_from_str("box.s := \"\"");
+                }
+                Expression expr = make_expr_from_str(e.second);
+                measure_(name, [&] {
+                    reset->evaluate();
+                    for (int i = 0; i < pieces; ++i) {
+                        Value v = expr->evaluate();
+                    }
+                }, pieces);
+            }
+        }
+    }
+
+    void BenchExpression::runBenchmarks_() {
+        benchCompare_();
+        benchBinaryOperators_();
+        benchAccumulation_();
+    }
+}
@@ -0,0 +1,26 @@
+//
+//  BenchExpression.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__BenchExpression__
+#define __archetype__BenchExpression__
+
+#include <string>
+
+#include "IBenchSuite.hh"
+
+namespace archetype {
+    class BenchExpression : public IBenchSuite {
+        void benchCompare_();
+        void benchBinaryOperators_();
+        void benchAccumulation_();
+    protected:
+        virtual void runBenchmarks_() override;
+    public:
+        BenchExpression(std::string name): IBenchSuite(name) { }
+    };
+}
+
+#endif /* defined(__archetype__BenchExpression__) */
@@ -0,0 +1,104 @@
+//
+//  BenchObject.cc
+//  archetype
+//
+//
+
+#include <string>
+
+#include "BenchObject.hh"
+#include "BenchRegistry.hh"
+#include "ComputedAttributes.hh"
+#include "Object.hh"
+#include "Universe.hh"
+#include "SourceFile.hh"
+#include "TokenStream.hh"
+
+using namespace std;
+
+namespace archetype {
+    ARCHETYPE_BENCH_REGISTER(BenchObject);
+
+    static void make_program(string name, string program) {
+        Universe::destroy();
+        TokenStream t(make_source_from_str(name, program));
+        if (not Universe::instance().make(t)) {
+            throw logic_error("Could not compile " + name + " for BenchObject");
+        }
+    }
+
+    void BenchObject::benchSendDepth_() {
+        for (int depth : {1, 8, 32}) {
+            string chained = "send/chained/" + to_string(depth);
+            if (wanted_(chained)) {
+                // Each link sends the message on to the next one.
+                string program;
+                for (int i = 0; i < depth; ++i) {
+                    program += "null link" + to_string(i) + "\nmethods\n  'step': ";
+                    program += (i + 1 < depth) ? "'step' -> link" + to_string(i + 1) : string("1");
+                    program += "\nend\n";
+                }
+                make_program(chained, program);
+                ObjectPtr first = Universe::instance().getObject("link0");
+                int step = Universe::instance().Messages.index("step");
+                measure_(chained, [&] { Value v = Object::send(first, Value{new MessageValue{step}}); }, depth);
+            }
+
+            string inherited = "send/inherited/" + to_string(depth);
+            if (wanted_(inherited)) {
+                // The only method is on the most distant ancestor.
+                string program = "type kind0 based on null\nmethods\n  'step': 1\nend\n";
+                for (int i = 1; i < depth; ++i) {
+                    program += "type kind" + to_string(i) + " based on kind" + to_string(i - 1) + " end\n";
+                }
+                program += "kind" + to_string(depth - 1) + " leaf end\n";
+                make_program(inherited, program);
+                ObjectPtr leaf = Universe::instance().getObject("leaf");
+                int step = Universe::instance().Messages.index("step");
+                measure_(inherited, [&] { Value v = Object::send(leaf, Value{new MessageValue{step}}); });
+            }
+        }
+    }
+
+    void BenchObject::benchAttributeDepth_() {
+        for (int depth : {1, 8, 32}) {
+            string inherited = "attribute/inherited/" + to_string(depth);
+            if (wanted_(inherited)) {
+                // The only attribute is on the most distant ancestor.
+                string program = "type kind0 based on null\n  weight: 1\nend\n";
+                for (int i = 1; i < depth; ++i) {
+                    program += "type kind" + to_string(i) + " based on kind" + to_string(i - 1) + " end\n";
+                }
+                program += "kind" + to_string(depth - 1) + " leaf end\n";
+                make_program(inherited, program);
+                Value weight{new AttributeValue{Universe::instance().getObject("leaf")->id(),
+                                                Universe::instance().Identifiers.index("weight")}};
+                measure_(inherited, [&] { Value v = weight->valueConversion(); });
+            }
+        }
+    }
+
+    void BenchObject::benchComputedAttribute_() {
+        for (bool kept : {true, false}) {
+            string name = kept ? "attribute/computed" : "attribute/computed/evaluated";
+            if (wanted_(name)) {
+                make_program(name,
+                             "null item\n"
+                             "  weight: 3  bulk: 4\n"
+                             "  heavy: weight * bulk > 10 and weight < 100\n"
+                             "end\n");
+                Value heavy{new AttributeValue{Universe::instance().getObject("item")->id(),
+                                               Universe::instance().Identifiers.index("heavy")}};
+                ComputedAttributes::Enabled = kept;
+                measure_(name, [&] { Value v = heavy->valueConversion(); });
+                ComputedAttributes::Enabled = true;
+            }
+        }
+    }
+
+    void BenchObject::runBenchmarks_() {
+        benchSendDepth_();
+        benchAttributeDepth_();
+        benchComputedAttribute_();
+    }
+}
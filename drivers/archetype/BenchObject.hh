@@ -0,0 +1,26 @@
+//
+//  BenchObject.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__BenchObject__
+#define __archetype__BenchObject__
+
+#include <string>
+
+#include "IBenchSuite.hh"
+
+namespace archetype {
+    class BenchObject : public IBenchSuite {
+        void benchSendDepth_();
+        void benchAttributeDepth_();
+        void benchComputedAttribute_();
+    protected:
+        virtual void runBenchmarks_() override;
+    public:
+        BenchObject(std::string name): IBenchSuite(name) { }
+    };
+}
+
+#endif /* defined(__archetype__BenchObject__) */
@@ -0,0 +1,98 @@
+//
+//  BenchRegistry.cc
+//  archetype
+//
+//
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <vector>
+
+#include "BenchRegistry.hh"
+
+using namespace std;
+
+namespace archetype {
+    BenchRegistry* BenchRegistry::instance_ = nullptr;
+
+    BenchRegistry& BenchRegistry::instance() {
+        if (not instance_) {
+            instance_ = new BenchRegistry();
+        }
+        return *instance_;
+    }
+
+    void BenchRegistry::destroy() {
+        delete instance_;
+        instance_ = nullptr;
+    }
+
+    BenchRegistry::BenchRegistry() {
+    }
+
+    BenchRegistry::~BenchRegistry() {
+    }
+
+    void BenchRegistry::registerSuite(IBenchSuite* suite) {
+        suites_.push_back(unique_ptr<IBenchSuite>(suite));
+    }
+
+    static string json_string(const string& s) {
+        string quoted = "\"";
+        for (char ch : s) {
+            switch (ch) {
+                case '"':  quoted += "\\\""; break;
+                case '\\': quoted += "\\\\"; break;
+                case '\n': quoted += "\\n"; break;
+                default:   quoted += ch; break;
+            }
+        }
+        return quoted + "\"";
+    }
+
+    static void write_summary(ostream& out, const BenchResult& result) {
+        vector<double> sorted = result.samples;
+        sort(sorted.begin(), sorted.end());
+        double mean = 0;
+        for (double s : sorted) {
+            mean += s;
+        }
+        mean /= sorted.size();
+        double variance = 0;
+        for (double s : sorted) {
+            variance += (s - mean) * (s - mean);
+        }
+        double stddev = sorted.size() > 1 ? sqrt(variance / (sorted.size() - 1)) : 0;
+        size_t middle = sorted.size() / 2;
+        double median = sorted.size() % 2 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2;
+        out << "    {\"name\": " << json_string(result.name)
+            << ", \"iterations\": " << result.iterations
+            << ", \"operations\": " << result.operations
+            << ", \"repetitions\": " << sorted.size()
+            << ", \"ns_per_op\": {"
+            << "\"min\": " << sorted.front()
+            << ", \"median\": " << median
+            << ", \"mean\": " << mean
+            << ", \"stddev\": " << stddev
+            << ", \"max\": " << sorted.back()
+            << "}}";
+    }
+
+    int BenchRegistry::runBenchmarks(string filter, int repetitions, ostream& out) {
+        vector<BenchResult> results;
+        for (auto& suite : suites_) {
+            suite->runBenchmarks(filter, max(repetitions, 1), results);
+        }
+        out << fixed << setprecision(2);
+        out << "{" << endl;
+        out << "  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+            out << (i ? "," : "") << endl;
+            write_summary(out, results[i]);
+        }
+        out << endl << "  ]" << endl;
+        out << "}" << endl;
+        return static_cast<int>(results.size());
+    }
+}
@@ -0,0 +1,48 @@
+//
+//  BenchRegistry.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__BenchRegistry__
+#define __archetype__BenchRegistry__
+
+#include <iostream>
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "IBenchSuite.hh"
+
+namespace archetype {
+    class BenchRegistry {
+        std::deque<std::unique_ptr<IBenchSuite>> suites_;
+    public:
+        static const int DefaultRepetitions = 10;
+
+        static BenchRegistry& instance();
+        static void destroy();
+
+        void registerSuite(IBenchSuite* suite);
+
+        // Runs every benchmark whose "Suite/name" contains the filter and writes
+        // a summary of each to out as JSON.  Returns the number of benchmarks run.
+        int runBenchmarks(std::string filter, int repetitions, std::ostream& out);
+    private:
+        static BenchRegistry* instance_;
+
+        BenchRegistry();
+        BenchRegistry(const BenchRegistry&) = delete;
+        BenchRegistry& operator=(const BenchRegistry) = delete;
+        ~BenchRegistry();
+    };
+}
+
+#define ARCHETYPE_BENCH_REGISTER(BNAME) \
+static class register_##BNAME { \
+public: register_##BNAME() { \
+BenchRegistry::instance().registerSuite(new BNAME(#BNAME)); \
+} \
+} stub_register_##BNAME
+
+#endif /* defined(__archetype__BenchRegistry__) */
@@ -0,0 +1,47 @@
+//
+//  BenchSerialization.cc
+//  archetype
+//
+//
+
+#include <vector>
+
+#include "BenchSerialization.hh"
+#include "BenchRegistry.hh"
+#include "Serialization.hh"
+
+using namespace std;
+
+namespace archetype {
+    ARCHETYPE_BENCH_REGISTER(BenchSerialization);
+
+    void BenchSerialization::benchVarints_() {
+        // Mostly small numbers, as identifiers and counts are, with some large and negative.
+        const int count = 1000;
+        vector<int> numbers;
+        for (int i = 0; i < count; ++i) {
+            int n = (i % 10 == 0) ? i * 7919 : i % 100;
+            numbers.push_back(i % 17 == 0 ? -n : n);
+        }
+        measure_("varint/write", [&] {
+            MemoryStorage mem;
+            for (int n : numbers) {
+                mem << n;
+            }
+        }, count);
+        measure_("varint/roundtrip", [&] {
+            MemoryStorage mem;
+            for (int n : numbers) {
+                mem << n;
+            }
+            int back;
+            for (int i = 0; i < count; ++i) {
+                mem >> back;
+            }
+        }, count);
+    }
+
+    void BenchSerialization::runBenchmarks_() {
+        benchVarints_();
+    }
+}
@@ -0,0 +1,24 @@
+//
+//  BenchSerialization.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__BenchSerialization__
+#define __archetype__BenchSerialization__
+
+#include <string>
+
+#include "IBenchSuite.hh"
+
+namespace archetype {
+    class BenchSerialization : public IBenchSuite {
+        void benchVarints_();
+    protected:
+        virtual void runBenchmarks_() override;
+    public:
+        BenchSerialization(std::string name): IBenchSuite(name) { }
+    };
+}
+
+#endif /* defined(__archetype__BenchSerialization__) */
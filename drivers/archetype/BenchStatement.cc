@@ -0,0 +1,46 @@
+//
+//  BenchStatement.cc
+//  archetype
+//
+//
+
+#include <string>
+
+#include "BenchStatement.hh"
+#include "BenchRegistry.hh"
+#include "Statement.hh"
+#include "Universe.hh"
+#include "SourceFile.hh"
+#include "TokenStream.hh"
+
+using namespace std;
+
+namespace archetype {
+    ARCHETYPE_BENCH_REGISTER(BenchStatement);
+
+    void BenchStatement::benchForEach_() {
+        for (int count : {10, 100, 1000}) {
+            string name = "for/each/" + to_string(count);
+            if (not wanted_(name)) {
+                continue;
+            }
+            // Every tenth object is lit, so the action runs on only a few of them.
+            string program = "type lamp based on null\n  lit: FALSE\nend\n";
+            for (int i = 0; i < count; ++i) {
+                program += "lamp lamp" + to_string(i) + (i % 10 ? "" : " lit: TRUE") + " end\n";
+            }
+            program += "null counter\n  n: 0\nend\n";
+            Universe::destroy();
+            TokenStream t(make_source_from_str(name, program));
+            if (not Universe::instance().make(t)) {
+                throw logic_error("Could not compile " + name + " for BenchStatement");
+            }
+            Statement stmt = make_stmt_from_str("for each.lit do counter.n +:= 1");
+            measure_(name, [&] { Value v = stmt->execute(); }, count);
+        }
+    }
+
+    void BenchStatement::runBenchmarks_() {
+        benchForEach_();
+    }
+}
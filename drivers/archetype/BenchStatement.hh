@@ -0,0 +1,24 @@
+//
+//  BenchStatement.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__BenchStatement__
+#define __archetype__BenchStatement__
+
+#include <string>
+
+#include "IBenchSuite.hh"
+
+namespace archetype {
+    class BenchStatement : public IBenchSuite {
+        void benchForEach_();
+    protected:
+        virtual void runBenchmarks_() override;
+    public:
+        BenchStatement(std::string name): IBenchSuite(name) { }
+    };
+}
+
+#endif /* defined(__archetype__BenchStatement__) */
@@ -0,0 +1,66 @@
+//
+//  BenchSystemParser.cc
+//  archetype
+//
+//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchSystemParser.hh"
+#include "BenchRegistry.hh"
+#include "SystemParser.hh"
+#include "Universe.hh"
+
+using namespace std;
+
+namespace archetype {
+    ARCHETYPE_BENCH_REGISTER(BenchSystemParser);
+
+    void BenchSystemParser::benchParse_() {
+        Universe::destroy();
+        unique_ptr<SystemParser> parser(new SystemParser);
+
+        // A vocabulary about the size of a typical game's.
+        vector<string> verbs = {
+            "get|take|pick up", "drop|put down", "look|l", "look at|examine|x", "open", "close",
+            "put", "push|press", "pull", "turn on", "turn off", "read", "wear", "remove",
+            "enter|go in", "exit|go out", "say", "wait|z", "inventory|i", "help", "hint",
+            "sit", "stand", "kick", "climb", "search", "break", "fill", "drink", "eat"
+        };
+        vector<string> adjectives = {"brass", "wooden", "red", "dusty", "glass", "sharp"};
+        vector<string> nouns = {"lamp", "table", "button", "cot", "cover", "latch", "key", "door",
+                                "box", "bulb", "guard", "elevator", "panel", "coffin", "book"};
+        int id = 1;
+        parser->setMode(SystemParser::VERBS);
+        for (auto const& verb : verbs) {
+            parser->addParseable(id++, verb);
+        }
+        parser->setMode(SystemParser::NOUNS);
+        for (auto const& adjective : adjectives) {
+            for (auto const& noun : nouns) {
+                parser->addParseable(id++, adjective + " " + noun + "|" + noun);
+            }
+        }
+        parser->close();
+
+        vector<pair<string, string>> commands = {
+            {"short", "look"},
+            {"verb-noun", "get the lamp"},
+            {"sentence", "put the brass lamp on the dusty wooden table"},
+            {"unknown", "xyzzy plugh the frobozz"}
+        };
+        for (auto const& command : commands) {
+            measure_("parse/" + command.first, [&] {
+                parser->parse(command.second);
+                while (parser->nextObject()->isDefined()) {
+                }
+            });
+        }
+    }
+
+    void BenchSystemParser::runBenchmarks_() {
+        benchParse_();
+    }
+}
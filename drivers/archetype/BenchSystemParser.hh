@@ -0,0 +1,24 @@
+//
+//  BenchSystemParser.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__BenchSystemParser__
+#define __archetype__BenchSystemParser__
+
+#include <string>
+
+#include "IBenchSuite.hh"
+
+namespace archetype {
+    class BenchSystemParser : public IBenchSuite {
+        void benchParse_();
+    protected:
+        virtual void runBenchmarks_() override;
+    public:
+        BenchSystemParser(std::string name): IBenchSuite(name) { }
+    };
+}
+
+#endif /* defined(__archetype__BenchSystemParser__) */
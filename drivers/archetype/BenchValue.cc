@@ -0,0 +1,77 @@
+//
+//  BenchValue.cc
+//  archetype
+//
+//
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BenchValue.hh"
+#include "BenchRegistry.hh"
+#include "Value.hh"
+#include "Universe.hh"
+
+using namespace std;
+
+namespace archetype {
+    ARCHETYPE_BENCH_REGISTER(BenchValue);
+
+    void BenchValue::benchConversions_() {
+        Value number{new NumericValue{1234}};
+        Value numeral{new StringValue{"1234"}};
+        Value text{new StringValue{"brass lamp"}};
+        Value message;
+        Value truth{new BooleanValue{true}};
+        Value literal;
+
+        vector<pair<string, function<void()>>> conversions = {
+            {"numericConversion/string", [&] { Value v = numeral->numericConversion(); }},
+            {"numericConversion/number", [&] { Value v = number->numericConversion(); }},
+            {"stringConversion/number", [&] { Value v = number->stringConversion(); }},
+            {"stringConversion/string", [&] { Value v = text->stringConversion(); }},
+            {"stringConversion/message", [&] { Value v = message->stringConversion(); }},
+            {"stringConversion/boolean", [&] { Value v = truth->stringConversion(); }},
+            {"messageConversion/string", [&] { Value v = text->messageConversion(); }},
+            {"messageConversion/literal", [&] { Value v = literal->messageConversion(); }},
+            {"valueConversion/string", [&] { Value v = text->valueConversion(); }}
+        };
+        // Messages and literals need a Universe, which is not worth making for nothing.
+        if (none_of(conversions.begin(), conversions.end(),
+                    [&](const pair<string, function<void()>>& c) { return wanted_(c.first); })) {
+            return;
+        }
+        Universe::destroy();
+        message = Value{new MessageValue{Universe::instance().Messages.index("brass lamp")}};
+        literal = Value{new TextLiteralValue{Universe::instance().TextLiterals.index("brass lamp")}};
+        for (auto const& c : conversions) {
+            measure_(c.first, c.second);
+        }
+    }
+
+    void BenchValue::benchLists_() {
+        Value text{new StringValue{"brass lamp"}};
+        Value list{new UndefinedValue};
+        for (int i = 0; i < 100; ++i) {
+            list = Value{new PairValue{Value{new NumericValue{i}}, std::move(list)}};
+        }
+
+        measure_("clone/string", [&] { Value v = text->clone(); });
+        measure_("clone/list100", [&] { Value v = list->clone(); });
+        measure_("walk/list100", [&] {
+            Value v = list->clone();
+            while (v->isDefined()) {
+                Value head = v->head();
+                v = v->tail();
+            }
+        });
+    }
+
+    void BenchValue::runBenchmarks_() {
+        benchConversions_();
+        benchLists_();
+    }
+}
@@ -0,0 +1,25 @@
+//
+//  BenchValue.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__BenchValue__
+#define __archetype__BenchValue__
+
+#include <string>
+
+#include "IBenchSuite.hh"
+
+namespace archetype {
+    class BenchValue : public IBenchSuite {
+        void benchConversions_();
+        void benchLists_();
+    protected:
+        virtual void runBenchmarks_() override;
+    public:
+        BenchValue(std::string name): IBenchSuite(name) { }
+    };
+}
+
+#endif /* defined(__archetype__BenchValue__) */
@@ -0,0 +1,57 @@
+//
+//  BenchWrappedOutput.cc
+//  archetype
+//
+//
+
+#include <string>
+#include <vector>
+
+#include "BenchWrappedOutput.hh"
+#include "BenchRegistry.hh"
+#include "WrappedOutput.hh"
+
+using namespace std;
+
+namespace archetype {
+    ARCHETYPE_BENCH_REGISTER(BenchWrappedOutput);
+
+    namespace {
+        // Discards everything, so that only the wrapping is measured.
+        class NullOutput : public IUserOutput {
+        public:
+            virtual void put(const std::string&) override { }
+            virtual void endLine() override { }
+            virtual void banner(char) override { }
+        };
+    }
+
+    void BenchWrappedOutput::benchPut_() {
+        UserOutput null_output{new NullOutput};
+        WrappedOutput wrapped{null_output, 80};
+        string paragraph =
+            "I am standing in the middle of a cavernous cryogenic freezer. There are other "
+            "glass coffins coming up out of the floor, just like mine.  From what I can tell "
+            "by the tiny indicator lights along the sides, the coffins are operating "
+            "normally.  Inside each one is a naked human form, the skin alabaster white and "
+            "hairy with ice crystals.";
+        measure_("put/paragraph", [&] {
+            wrapped.put(paragraph);
+            wrapped.endLine();
+        });
+
+        // The way `write` puts out a sentence, one expression at a time.
+        vector<string> pieces = {"I can see ", "a glass coffin", ", ", "a big red button",
+                                 " and ", "a turbolift elevator", "."};
+        measure_("put/pieces", [&] {
+            for (auto const& piece : pieces) {
+                wrapped.put(piece);
+            }
+            wrapped.endLine();
+        });
+    }
+
+    void BenchWrappedOutput::runBenchmarks_() {
+        benchPut_();
+    }
+}
@@ -0,0 +1,24 @@
+//
+//  BenchWrappedOutput.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__BenchWrappedOutput__
+#define __archetype__BenchWrappedOutput__
+
+#include <string>
+
+#include "IBenchSuite.hh"
+
+namespace archetype {
+    class BenchWrappedOutput : public IBenchSuite {
+        void benchPut_();
+    protected:
+        virtual void runBenchmarks_() override;
+    public:
+        BenchWrappedOutput(std::string name): IBenchSuite(name) { }
+    };
+}
+
+#endif /* defined(__archetype__BenchWrappedOutput__) */
@@ -0,0 +1,127 @@
+//
+//  ComputedAttributes.cc
+//  archetype
+//
+//
+
+#include "ComputedAttributes.hh"
+#include "Expression.hh"
+#include "Universe.hh"
+
+using namespace std;
+
+namespace archetype {
+
+    bool ComputedAttributes::Enabled = true;
+
+    ComputedAttributes* ComputedAttributes::instance_ = nullptr;
+
+    ComputedAttributes& ComputedAttributes::instance() {
+        if (not instance_) {
+            instance_ = new ComputedAttributes;
+        }
+        return *instance_;
+    }
+
+    void ComputedAttributes::destroy() {
+        delete instance_;
+        instance_ = nullptr;
+    }
+
+    ComputedAttributes::ComputedAttributes():
+    hits_{0}
+    { }
+
+    static Value evaluate_as(const ObjectPtr& obj, const IExpression& expr) {
+        ContextScope c;
+        c->selfObject = obj;
+        return expr.evaluate();
+    }
+
+    Value ComputedAttributes::evaluate(const ObjectPtr& obj, int attribute_id, const IExpression& expr) {
+        if (Enabled and not IExpression::Debug) {
+            Memo& memo = memos_[make_pair(obj->id(), attribute_id)];
+            if (memo.expression != &expr or not current_(memo)) {
+                memo = Memo{&expr, expr.isPure(), nullptr, {Read{attribute_id, writesTo_(attribute_id)}}};
+                if (memo.pure) {
+                    return evaluateAndKeep_(obj, attribute_id, expr);
+                }
+            } else if (memo.pure and memo.value) {
+                hits_++;
+                if (not frames_.empty()) {
+                    noteReads_(memo.reads);
+                }
+                return memo.value->clone();
+            }
+        }
+        // Whatever is evaluating around this cannot be kept either.
+        if (not frames_.empty()) {
+            noteImpure_();
+        }
+        return evaluate_as(obj, expr);
+    }
+
+    Value ComputedAttributes::evaluateAndKeep_(const ObjectPtr& obj, int attribute_id, const IExpression& expr) {
+        frames_.push_back(Frame{{Read{attribute_id, writesTo_(attribute_id)}}, true});
+        Value value;
+        try {
+            value = evaluate_as(obj, expr);
+        } catch (...) {
+            frames_.pop_back();
+            throw;
+        }
+        Frame frame = std::move(frames_.back());
+        frames_.pop_back();
+        if (not frames_.empty()) {
+            noteReads_(frame.reads);
+            if (not frame.pure) {
+                noteImpure_();
+            }
+        }
+        auto key = make_pair(obj->id(), attribute_id);
+        if (frame.pure) {
+            Memo& memo = memos_[key];
+            memo.value = value->clone();
+            memo.reads = std::move(frame.reads);
+        } else {
+            // It read an attribute whose own expression is not pure.
+            memos_.erase(key);
+        }
+        return value;
+    }
+
+    void ComputedAttributes::attributeWritten(int attribute_id) {
+        if (attribute_id >= static_cast<int>(writes_.size())) {
+            writes_.resize(attribute_id + 1, 0);
+        }
+        writes_[attribute_id]++;
+    }
+
+    bool ComputedAttributes::current_(const Memo& memo) const {
+        for (auto const& read : memo.reads) {
+            if (writesTo_(read.first) != read.second) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void ComputedAttributes::noteRead_(int attribute_id) {
+        vector<Read>& reads = frames_.back().reads;
+        if (reads.empty() or reads.back().first != attribute_id) {
+            reads.push_back(Read{attribute_id, writesTo_(attribute_id)});
+        }
+    }
+
+    void ComputedAttributes::noteReads_(const vector<Read>& reads) {
+        vector<Read>& into = frames_.back().reads;
+        into.insert(into.end(), reads.begin(), reads.end());
+    }
+
+    void ComputedAttributes::noteImpure_() {
+        for (auto& frame : frames_) {
+            frame.pure = false;
+        }
+    }
+
+}
@@ -0,0 +1,93 @@
+//
+//  ComputedAttributes.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__ComputedAttributes__
+#define __archetype__ComputedAttributes__
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "Object.hh"
+#include "Value.hh"
+
+namespace archetype {
+
+    // The values of computed attributes, kept from one read to the next.
+    //
+    // An attribute holding an expression is evaluated again every time it is read.
+    // When the expression is pure, doing nothing but reading attributes and working
+    // on values, its value for an object can only change when one of the attributes
+    // read along the way is written.  So the value is kept, along with which
+    // attributes were read and how many times each had been written, and is used
+    // again for as long as none of those has been written since.
+    //
+    // Creating or destroying an object, or loading a Universe, forgets everything.
+    class ComputedAttributes {
+    public:
+        // Whether values are kept at all; when not, every read evaluates again.
+        static bool Enabled;
+
+        static ComputedAttributes& instance();
+        static void destroy();
+
+        // The value of the attribute of obj, which is held by expr in obj or one of
+        // its ancestors.
+        Value evaluate(const ObjectPtr& obj, int attribute_id, const IExpression& expr);
+
+        void attributeRead(int attribute_id) {
+            if (not frames_.empty()) {
+                noteRead_(attribute_id);
+            }
+        }
+        void attributeWritten(int attribute_id);
+        void objectsChanged() { memos_.clear(); }
+
+        // Kept values, whether or not still current.
+        std::size_t size() const { return memos_.size(); }
+        long long hits() const { return hits_; }
+
+    private:
+        // An attribute read, and how many writes it had had when read.
+        typedef std::pair<int, unsigned long long> Read;
+
+        struct Memo {
+            const IExpression* expression;
+            bool pure;
+            Value value;
+            std::vector<Read> reads;
+        };
+
+        // What one evaluation in progress has read so far.
+        struct Frame {
+            std::vector<Read> reads;
+            bool pure;
+        };
+
+        std::map<std::pair<int, int>, Memo> memos_;
+        std::vector<unsigned long long> writes_;
+        std::vector<Frame> frames_;
+        long long hits_;
+
+        static ComputedAttributes* instance_;
+
+        ComputedAttributes();
+        ComputedAttributes(const ComputedAttributes&) = delete;
+        ComputedAttributes& operator=(const ComputedAttributes&) = delete;
+
+        unsigned long long writesTo_(int attribute_id) const {
+            return attribute_id < static_cast<int>(writes_.size()) ? writes_[attribute_id] : 0;
+        }
+        Value evaluateAndKeep_(const ObjectPtr& obj, int attribute_id, const IExpression& expr);
+        bool current_(const Memo& memo) const;
+        void noteRead_(int attribute_id);
+        void noteReads_(const std::vector<Read>& reads);
+        void noteImpure_();
+    };
+
+}
+
+#endif /* defined(__archetype__ComputedAttributes__) */
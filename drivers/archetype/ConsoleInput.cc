@@ -24,7 +24,7 @@ using namespace std;
 
 namespace archetype {
     char ConsoleInput::getKey() {
-        cout.flush();
+        Universe::instance().output()->flush();
         Universe::instance().output()->resetPager();
 #ifdef _XOPEN_VERSION
         struct termios term;
@@ -59,6 +59,7 @@ namespace archetype {
 
     string ConsoleInput::getLine() {
         string line;
+        Universe::instance().output()->flush();
         getline(cin, line);
         Universe::instance().output()->resetPager();
         return line;
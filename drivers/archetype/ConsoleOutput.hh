@@ -10,16 +10,27 @@
 #define __archetype__ConsoleOutput__
 
 #include <iostream>
+#include <string>
 
 #include "UserOutput.hh"
 
 namespace archetype {
+    // Collects everything written between flushes into one buffer, so that a turn's
+    // worth of text reaches the console in a single write.
     class ConsoleOutput : public IUserOutput {
+        std::string buffer_;
     public:
-        virtual ~ConsoleOutput() { }
-        virtual void put(const std::string& line) override { std::cout << line; std::cout.flush(); }
-        virtual void endLine() override { std::cout << std::endl; }
-        virtual void banner(char ch) override { for (int i = 0; i < 80; ++i) std::cout << ch; endLine(); }
+        virtual ~ConsoleOutput() { flush(); }
+        virtual void put(const std::string& line) override { buffer_ += line; }
+        virtual void endLine() override { buffer_ += '\n'; }
+        virtual void banner(char ch) override { buffer_.append(80, ch); endLine(); }
+        virtual void flush() override {
+            if (not buffer_.empty()) {
+                std::cout.write(buffer_.data(), buffer_.size());
+                buffer_.clear();
+            }
+            std::cout.flush();
+        }
     };
 }
 
@@ -10,11 +10,12 @@
 #include <cassert>
 #include <algorithm>
 #include <sstream>
-#include <cmath>
 #include <random>
+#include <typeinfo>
 #include <stack>
 
 #include "Expression.hh"
+#include "ComputedAttributes.hh"
 #include "Keywords.hh"
 #include "Universe.hh"
 
@@ -41,6 +42,24 @@ namespace archetype {
         Universe::instance().output()->endLine();
     }
 
+    static unique_ptr<mt19937> random_generator;
+
+    static mt19937& the_random_generator() {
+        if (not random_generator) {
+            random_device rd;
+            random_generator.reset(new mt19937(rd()));
+        }
+        return *random_generator;
+    }
+
+    void seed_random(unsigned seed) {
+        random_generator.reset(new mt19937(seed));
+    }
+
+    unsigned draw_random_seed() {
+        return static_cast<unsigned>(the_random_generator()());
+    }
+
     inline Value as_boolean_value(bool value) {
         return Value{new BooleanValue{value}};
     }
@@ -160,6 +179,42 @@ namespace archetype {
         out << VALUE << value_;
     }
 
+    void References::gather(const Value& value) {
+        const IValue* v = value.get();
+        // Lists are walked along their tails, however long they are.
+        while (auto pair = dynamic_cast<const PairValue*>(v)) {
+            gather(pair->head());
+            Value tail = pair->tail();
+            if (not dynamic_cast<const PairValue*>(tail.get())) {
+                gather(tail);
+                return;
+            }
+            v = tail.get();
+        }
+        if (auto message = dynamic_cast<const MessageValue*>(v)) {
+            messages.insert(message->getMessage());
+        } else if (auto literal = dynamic_cast<const TextLiteralValue*>(v)) {
+            textLiterals.insert(literal->textLiteral());
+        } else if (auto identifier = dynamic_cast<const IdentifierValue*>(v)) {
+            identifiers.insert(identifier->getIdentifier());
+        } else if (auto object = dynamic_cast<const ObjectValue*>(v)) {
+            objects.insert(object->getObject());
+        } else if (auto attribute = dynamic_cast<const AttributeValue*>(v)) {
+            identifiers.insert(attribute->getIdentifier());
+            objects.insert(attribute->objectId());
+        }
+    }
+
+    bool ValueExpression::appendInPlace(const string& text) {
+        StringValue* value_s = dynamic_cast<StringValue*>(value_.get());
+        if (value_s and value_.unique()) {
+            value_s->append(text);
+            return true;
+        } else {
+            return false;
+        }
+    }
+
     // This node is for those reserved words that behave like zero-argument
     // functions (sender, read, key, and so forth).
     class ReservedWordNode : public IExpression {
@@ -168,6 +223,8 @@ namespace archetype {
         ReservedWordNode(Keywords::Reserved_e word): word_(word) { }
         virtual void write(Storage& out) const override;
         virtual Value evaluate() const override;
+        // Only self is the same wherever an attribute is read through the same object.
+        virtual bool isPure() const override { return word_ == Keywords::RW_SELF; }
         virtual void prefixDisplay(std::ostream& out) const override {
             out << Keywords::instance().Reserved.get(word_);
         }
@@ -183,10 +240,13 @@ namespace archetype {
         IdentifierNode(int id): id_{id} { }
         int id() const { return id_; }
         virtual void write(Storage& out) const override { out << IDENTIFIER << id_; }
+        virtual void gatherReferences(References& refs) const override { refs.identifiers.insert(id_); }
+        virtual bool isPure() const override { return true; }
         virtual Value evaluate() const override {
             Value result;
             // Closest binding:  an attribute in the current object
             ObjectPtr selfObject = Universe::instance().currentContext().selfObject;
+            ComputedAttributes::instance().attributeRead(id_);
             if (selfObject and selfObject->hasAttribute(id_)) {
                 result = Value(new AttributeValue(selfObject->id(), id_));
             } else {
@@ -211,6 +271,87 @@ namespace archetype {
         }
     };
 
+    // An identifier that only ever names one object.
+    class ObjectNameNode : public IdentifierNode {
+        Value object_;
+    public:
+        ObjectNameNode(int id, int object_id): IdentifierNode{id}, object_{new ObjectValue{object_id}} { }
+        virtual Value evaluate() const override {
+            Value result = object_->clone();
+            if (IExpression::Debug) {
+                debug_expr(*this, result);
+            }
+            return result;
+        }
+    };
+
+    // An identifier only ever declared as a keyword, which is always just itself.
+    class KeywordNode : public IdentifierNode {
+        Value keyword_;
+    public:
+        KeywordNode(int id): IdentifierNode{id}, keyword_{new IdentifierValue{id}} { }
+        virtual Value evaluate() const override {
+            Value result = keyword_->clone();
+            if (IExpression::Debug) {
+                debug_expr(*this, result);
+            }
+            return result;
+        }
+    };
+
+    // An identifier only ever used as an attribute, which no object is named.
+    class SelfAttributeNode : public IdentifierNode {
+    public:
+        SelfAttributeNode(int id): IdentifierNode{id} { }
+        virtual Value evaluate() const override {
+            Value result;
+            ObjectPtr selfObject = Universe::instance().currentContext().selfObject;
+            ComputedAttributes::instance().attributeRead(id());
+            if (selfObject and selfObject->hasAttribute(id())) {
+                result = Value{new AttributeValue{selfObject->id(), id()}};
+            } else {
+                result = Value{new IdentifierValue{id()}};
+            }
+            if (IExpression::Debug) {
+                debug_expr(*this, result);
+            }
+            return result;
+        }
+    };
+
+    // Anything named in more than one way, or never declared at all, is left to
+    // be looked up as it is evaluated.
+    static Expression bound_identifier(int id) {
+        Universe& u = Universe::instance();
+        switch (u.identifierKind(id)) {
+            case OBJECT_ID: {
+                auto named = u.ObjectIdentifiers.find(id);
+                if (named != u.ObjectIdentifiers.end()) {
+                    return Expression{new ObjectNameNode{id, named->second}};
+                }
+                break;
+            }
+            case KEYWORD_ID:
+                return Expression{new KeywordNode{id}};
+            case DEFINED_ATTRIBUTE_ID:
+            case REFERENCED_ATTRIBUTE_ID:
+                return Expression{new SelfAttributeNode{id}};
+            default:
+                break;
+        }
+        return Expression{new IdentifierNode{id}};
+    }
+
+    void bind_identifiers(Expression& expr) {
+        if (auto id_node = dynamic_cast<const IdentifierNode*>(expr.get())) {
+            Expression bound = bound_identifier(id_node->id());
+            bound->setPosition(expr->position());
+            expr = std::move(bound);
+        } else {
+            expr->bindIdentifiers();
+        }
+    }
+
     class Operator : public IExpression {
         Keywords::Operators_e op_;
     protected:
@@ -245,6 +386,16 @@ namespace archetype {
             return right_->verify(t);
         }
 
+        virtual void gatherReferences(References& refs) const override {
+            right_->gatherReferences(refs);
+        }
+        virtual void bindIdentifiers() override {
+            bind_identifiers(right_);
+        }
+        virtual bool isPure() const override {
+            return op() != Keywords::OP_RANDOM and right_->isPure();
+        }
+
         virtual void write(Storage& out) const override {
             out << UNARY;
             int op_as_int = static_cast<int>(op());
@@ -276,10 +427,8 @@ namespace archetype {
                 case Keywords::OP_RANDOM: {
                     Value rv_n = rv->numericConversion();
                     if (rv_n->isDefined() and rv_n->getNumber() > 0) {
-                        random_device rd;
-                        mt19937 gen(rd());
                         uniform_int_distribution<> dis(1, rv_n->getNumber());
-                        int r_i = dis(gen);
+                        int r_i = dis(the_random_generator());
                         result = Value{new NumericValue{r_i}};
                     } else {
                         result = Value{new UndefinedValue};
@@ -343,7 +492,7 @@ namespace archetype {
         }
     };
 
-    Value eval_ss(Keywords::Operators_e op, string lv_s, string rv_s) {
+    Value eval_ss(Keywords::Operators_e op, const string& lv_s, const string& rv_s) {
         switch (op) {
             case Keywords::OP_CONCAT:
                 return Value(new StringValue(lv_s + rv_s));
@@ -360,7 +509,7 @@ namespace archetype {
         }
     }
 
-    Value eval_sn(Keywords::Operators_e op, string lv_s, int rv_n) {
+    Value eval_sn(Keywords::Operators_e op, const string& lv_s, int rv_n) {
         switch (op) {
             case Keywords::OP_LEFTFROM:
                 return Value(new StringValue(lv_s.substr(0, rv_n)));
@@ -373,6 +522,26 @@ namespace archetype {
         }
     }
 
+    // Exact where floating-point pow would round, and wrapping rather than undefined
+    // on overflow.  A negative power truncates toward zero, as pow's result did.
+    static int int_power(int base, int exponent) {
+        if (exponent < 0) {
+            if (base == 1 or base == -1) {
+                return (exponent % 2) ? base : 1;
+            }
+            return 0;
+        }
+        unsigned result = 1;
+        unsigned factor = static_cast<unsigned>(base);
+        for (unsigned e = static_cast<unsigned>(exponent); e; e >>= 1) {
+            if (e & 1) {
+                result *= factor;
+            }
+            factor *= factor;
+        }
+        return static_cast<int>(result);
+    }
+
     Value eval_nn(Keywords::Operators_e op, int lv_n, int rv_n) {
         int result;
         switch (op) {
@@ -380,14 +549,49 @@ namespace archetype {
             case Keywords::OP_MINUS:    result = lv_n - rv_n;     break;
             case Keywords::OP_MULTIPLY: result = lv_n * rv_n;     break;
             case Keywords::OP_DIVIDE:   result = lv_n / rv_n;     break;
-            case Keywords::OP_POWER:    result = static_cast<int>(pow(lv_n, rv_n)); break;
+            case Keywords::OP_POWER:    result = int_power(lv_n, rv_n);  break;
             default:
                 throw logic_error("number-op-number attempted on this operator");
         }
         return Value{new NumericValue{result}};
     }
 
+    static bool compare_numbers(Keywords::Operators_e op, int ln, int rn) {
+        switch (op) {
+            case Keywords::OP_EQ: return ln == rn;
+            case Keywords::OP_NE: return ln != rn;
+            case Keywords::OP_LT: return ln <  rn;
+            case Keywords::OP_LE: return ln <= rn;
+            case Keywords::OP_GE: return ln >= rn;
+            case Keywords::OP_GT: return ln >  rn;
+            default: throw logic_error("Unexpected numeric eval_compare case");
+        }
+    }
+
     bool eval_compare(Keywords::Operators_e op, const Value& lv, const Value& rv) {
+        // Operands of the same kind are compared directly, rather than by trying
+        // each conversion in turn; the answers are the ones the conversions give.
+        if (typeid(*lv) == typeid(*rv)) {
+            if (auto l_num = dynamic_cast<const NumericValue*>(lv.get())) {
+                return compare_numbers(op, l_num->getNumber(), rv->getNumber());
+            }
+            if (auto l_obj = dynamic_cast<const ObjectValue*>(lv.get())) {
+                bool same = l_obj->getObject() == rv->getObject();
+                return op == Keywords::OP_EQ ? same : op == Keywords::OP_NE ? not same : false;
+            }
+            // Different messages have different names, but their order is that of
+            // the names, so only (in)equality is certain from the ids.
+            if (auto l_msg = dynamic_cast<const MessageValue*>(lv.get())) {
+                bool same = l_msg->getMessage() == rv->getMessage();
+                if (same or op == Keywords::OP_EQ or op == Keywords::OP_NE) {
+                    return compare_numbers(op, 0, same ? 0 : 1);
+                }
+            }
+            if (lv->isSameValueAs(rv) and dynamic_cast<const TextLiteralValue*>(lv.get())) {
+                return compare_numbers(op, 0, 0);
+            }
+        }
+
         // Quick shortcut for identity.  Will also catch (v = UNDEFINED) and (UNDEFINED = v).
         if (op == Keywords::OP_EQ and lv->isSameValueAs(rv)) {
             return true;
@@ -407,23 +611,13 @@ namespace archetype {
         Value lv_n = lv->numericConversion();
         Value rv_n = rv->numericConversion();
         if (lv_n->isDefined() and rv_n->isDefined()) {
-            int ln = lv_n->getNumber();
-            int rn = rv_n->getNumber();
-            switch (op) {
-                case Keywords::OP_EQ: return ln == rn;
-                case Keywords::OP_NE: return ln != rn;
-                case Keywords::OP_LT: return ln <  rn;
-                case Keywords::OP_LE: return ln <= rn;
-                case Keywords::OP_GE: return ln >= rn;
-                case Keywords::OP_GT: return ln >  rn;
-                default: throw logic_error("Unexpected numeric eval_compare case");
-            }
+            return compare_numbers(op, lv_n->getNumber(), rv_n->getNumber());
         }
         Value lv_s = lv->stringConversion();
         Value rv_s = rv->stringConversion();
         if (lv_s->isDefined() and rv_s->isDefined()) {
-            string ls = lv_s->getString();
-            string rs = rv_s->getString();
+            const string& ls = lv_s->getString();
+            const string& rs = rv_s->getString();
             switch (op) {
                 case Keywords::OP_EQ: return ls == rs;
                 case Keywords::OP_NE: return ls != rs;
@@ -465,6 +659,9 @@ namespace archetype {
         right_{std::move(right)}
         {
             assert(is_binary(op));
+            if (left_) {
+                setPosition(left_->position());
+            }
         }
 
         virtual bool verify(TokenStream& t) const override {
@@ -593,8 +790,12 @@ namespace archetype {
                     Value lv = left_->evaluate();
                     Value rv = right_->evaluate();
                     Value lv_a = lv->attributeConversion();
-                    Value lv_s = lv->stringConversion();
                     Value rv_s = rv->stringConversion();
+                    if (rv_s->isDefined() and lv_a->appendInPlace(rv_s->getString())) {
+                        result = std::move(lv_a);
+                        break;
+                    }
+                    Value lv_s = lv->stringConversion();
                     Value rv_c;
                     if (lv_s->isDefined() and rv_s->isDefined()) {
                         rv_c = eval_ss(non_assignment_equivalent(op()), lv_s->getString(), rv_s->getString());
@@ -641,23 +842,9 @@ namespace archetype {
                 }
 
                 case Keywords::OP_SEND:
-                case Keywords::OP_PASS: {
-                    Value lv_v = left_->evaluate()->valueConversion();
-                    Value rv_o = right_->evaluate()->objectConversion();
-                    if (not rv_o->isDefined()) {
-                        result = std::move(rv_o);
-                    } else {
-                        ObjectPtr recipient = Universe::instance().getObject(rv_o->getObject());
-                        if (not recipient) {
-                            result = Value{new UndefinedValue};
-                        } else if (op() == Keywords::OP_PASS or recipient->isPrototype()) {
-                            result = Object::pass(recipient, std::move(lv_v));
-                        } else {
-                            result = Object::send(recipient, std::move(lv_v));
-                        }
-                    }
+                case Keywords::OP_PASS:
+                    result = send_(false);
                     break;
-                }
 
                 default:
                     if (is_binary(op())) {
@@ -675,11 +862,68 @@ namespace archetype {
             return result;
         }
 
+        virtual Value evaluateTail() const override {
+            if (op() == Keywords::OP_SEND or op() == Keywords::OP_PASS) {
+                return send_(true);
+            }
+            return evaluate();
+        }
+
+        Value send_(bool tail) const {
+            Value lv_v = left_->evaluate()->valueConversion();
+            Value rv_o = right_->evaluate()->objectConversion();
+            if (not rv_o->isDefined()) {
+                return rv_o;
+            }
+            ObjectPtr recipient = Universe::instance().getObject(rv_o->getObject());
+            if (not recipient) {
+                return Value{new UndefinedValue};
+            } else if (op() == Keywords::OP_PASS or recipient->isPrototype()) {
+                return tail ? Object::tailPass(std::move(recipient), std::move(lv_v)) :
+                              Object::pass(std::move(recipient), std::move(lv_v));
+            } else {
+                return tail ? Object::tailSend(std::move(recipient), std::move(lv_v)) :
+                              Object::send(std::move(recipient), std::move(lv_v));
+            }
+        }
+
         virtual void tieOnRightSide(Keywords::Operators_e op, Expression rightSide) override {
             right_ = tie_on_rside(std::move(right_), op, std::move(rightSide));
         }
 
         virtual int nodeCount() const override { return 1 + left_->nodeCount() + right_->nodeCount(); }
+        virtual void gatherReferences(References& refs) const override {
+            if (op() == Keywords::OP_SEND or op() == Keywords::OP_PASS) {
+                auto literal = dynamic_cast<const ValueExpression*>(left_.get());
+                if (not literal or not dynamic_cast<const MessageValue*>(literal->value().get())) {
+                    refs.namedSends = true;
+                }
+            }
+            left_->gatherReferences(refs);
+            right_->gatherReferences(refs);
+        }
+        virtual void bindIdentifiers() override {
+            bind_identifiers(left_);
+            // The right side of '.' only ever names the attribute, and is never evaluated.
+            if (op() != Keywords::OP_DOT) {
+                bind_identifiers(right_);
+            }
+        }
+        virtual bool isPure() const override {
+            switch (op()) {
+                case Keywords::OP_SEND:
+                case Keywords::OP_PASS:
+                case Keywords::OP_ASSIGN:
+                case Keywords::OP_C_CONCAT:
+                case Keywords::OP_C_DIVIDE:
+                case Keywords::OP_C_MINUS:
+                case Keywords::OP_C_MULTIPLY:
+                case Keywords::OP_C_PLUS:
+                    return false;
+                default:
+                    return left_->isPure() and right_->isPure();
+            }
+        }
         virtual Expression anyFewerNodeEquivalent() override {
             left_ = tighten(std::move(left_));
             right_ = tighten(std::move(right_));
@@ -898,7 +1142,9 @@ namespace archetype {
             more = t.fetch();
         }
         if (more) {
+            SourcePosition position = t.position();
             if (Expression node = get_operand_node(t)) {
+                node->setPosition(position);
                 return node;
             }
         }
@@ -1012,7 +1258,7 @@ namespace archetype {
             case IDENTIFIER: {
                 int id;
                 in >> id;
-                expr.reset(new IdentifierNode(id));
+                expr = bound_identifier(id);
                 break;
             }
             case VALUE: {
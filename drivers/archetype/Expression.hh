@@ -11,11 +11,14 @@
 
 #include <iostream>
 #include <memory>
+#include <set>
 #include <stdexcept>
 #include <string>
 
 #include "Keywords.hh"
+#include "SourceFile.hh"
 #include "TokenStream.hh"
+#include "NodePool.hh"
 #include "Value.hh"
 #include "Serialization.hh"
 
@@ -24,7 +27,25 @@ namespace archetype {
     class IExpression;
     typedef std::unique_ptr<IExpression> Expression;
 
+    // Everything a piece of compiled code refers to, as gathered by strip_universe
+    // to find what a program can reach.
+    struct References {
+        std::set<int> messages;
+        std::set<int> textLiterals;
+        std::set<int> identifiers;
+        std::set<int> objects;
+        // Whether anything other than a message literal is sent, which could be a
+        // message named by a string.
+        bool namedSends;
+        // Whether there is a 'for each', which can reach every instance.
+        bool eachObject;
+
+        References(): namedSends{false}, eachObject{false} { }
+        void gather(const Value& value);
+    };
+
     class IExpression {
+        SourcePosition position_;
     protected:
         IExpression() { }
     public:
@@ -34,6 +55,10 @@ namespace archetype {
         IExpression& operator=(const IExpression&) = delete;
         virtual ~IExpression() { }
 
+        // Nodes are kept in the NodePool rather than allocated one by one.
+        static void* operator new(std::size_t size) { return NodePool::instance().allocate(size); }
+        static void operator delete(void* node, std::size_t size) { NodePool::instance().release(node, size); }
+
         virtual void write(Storage& out) const = 0;
 
         virtual bool bindsBefore(Keywords::Operators_e op) const { return true; }
@@ -42,9 +67,24 @@ namespace archetype {
         virtual Expression anyFewerNodeEquivalent() { return nullptr; }
         virtual int nodeCount() const { return 1; }
         virtual bool verify(TokenStream& t) const { return true; }
+        virtual void gatherReferences(References&) const { }
+        // Bind the identifiers beneath this node; see bind_identifiers.
+        virtual void bindIdentifiers() { }
+        // Whether evaluating does nothing but read attributes and work on values, so
+        // that the value can be kept until one of those attributes is written; see
+        // ComputedAttributes.
+        virtual bool isPure() const { return false; }
 
         virtual void prefixDisplay(std::ostream& out) const = 0;
         virtual Value evaluate() const = 0;
+        // Evaluate as the last thing a method does, where a send or pass may be
+        // left for the dispatching object to deliver; see Object::tailSend.
+        virtual Value evaluateTail() const { return evaluate(); }
+
+        // Where the expression begins in its source.  Positions are not serialized,
+        // so they are only known in a Universe compiled in this run.
+        SourcePosition position() const { return position_; }
+        void setPosition(SourcePosition position) { position_ = position; }
     };
 
     class ValueExpression : public IExpression {
@@ -54,6 +94,11 @@ namespace archetype {
         virtual void write(Storage& out) const override;
         virtual Value evaluate() const override { return value_->clone(); }
         virtual void prefixDisplay(std::ostream& out) const override { out << value_; }
+        virtual void gatherReferences(References& refs) const override { refs.gather(value_); }
+        virtual bool isPure() const override { return true; }
+
+        const Value& value() const { return value_; }
+        bool appendInPlace(const std::string& text);
     };
 
     bool is_binary(Keywords::Operators_e op);
@@ -64,8 +109,21 @@ namespace archetype {
     Expression form_expr(TokenStream& t, int stop_precedence = 0);
     Expression tighten(Expression expr);
 
+    // Once a program is compiled, the Universe knows what each identifier names,
+    // so an identifier naming only an object, only a keyword or only attributes
+    // can be evaluated as just that, rather than by searching for it every time.
+    // Replaces expr if it is an identifier, or binds the identifiers beneath it.
+    void bind_identifiers(Expression& expr);
+
     bool eval_compare(Keywords::Operators_e op, const Value& lv, const Value& rv);
 
+    // The `random` operator draws from one generator, seeded unpredictably
+    // unless this is called first.  Replays seed it so that runs repeat exactly.
+    void seed_random(unsigned seed);
+    // A seed drawn from that generator, so that seeding with it later repeats
+    // whatever follows exactly.
+    unsigned draw_random_seed();
+
     Expression make_expr(TokenStream& t);
     Expression make_expr_from_str(std::string src_str);
 
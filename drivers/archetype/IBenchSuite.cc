@@ -0,0 +1,58 @@
+//
+//  IBenchSuite.cc
+//  archetype
+//
+//
+
+#include <algorithm>
+#include <chrono>
+
+#include "IBenchSuite.hh"
+
+using namespace std;
+
+namespace archetype {
+    // Each sample runs the body often enough to take at least this long, so that
+    // clock resolution and call overhead are lost in the noise.
+    const long long MinSampleNanoseconds = 10 * 1000 * 1000;
+    const int WarmupSamples = 2;
+
+    static long long time_calls(const function<void()>& body, long long iterations) {
+        auto start = chrono::steady_clock::now();
+        for (long long i = 0; i < iterations; ++i) {
+            body();
+        }
+        auto finish = chrono::steady_clock::now();
+        return chrono::duration_cast<chrono::nanoseconds>(finish - start).count();
+    }
+
+    bool IBenchSuite::wanted_(string name) const {
+        return (name_ + "/" + name).find(filter_) != string::npos;
+    }
+
+    void IBenchSuite::measure_(string name, function<void()> body, int operations) {
+        if (not results_ or not wanted_(name)) {
+            return;
+        }
+        // Double the calls per sample until a sample is long enough to trust.
+        long long iterations = 1;
+        long long elapsed;
+        while ((elapsed = time_calls(body, iterations)) < MinSampleNanoseconds) {
+            if (elapsed <= 0) {
+                iterations *= 2;
+            } else {
+                long long needed = iterations * MinSampleNanoseconds / elapsed + 1;
+                iterations = max(iterations * 2, min(needed, iterations * 100));
+            }
+        }
+        for (int i = 0; i < WarmupSamples; ++i) {
+            time_calls(body, iterations);
+        }
+        BenchResult result{name_ + "/" + name, iterations, operations, {}};
+        for (int i = 0; i < repetitions_; ++i) {
+            double per_operation = double(time_calls(body, iterations)) / (iterations * operations);
+            result.samples.push_back(per_operation);
+        }
+        results_->push_back(result);
+    }
+}
@@ -0,0 +1,63 @@
+//
+//  IBenchSuite.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__IBenchSuite__
+#define __archetype__IBenchSuite__
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace archetype {
+    struct BenchResult {
+        std::string name;
+        // Calls of the body per timed sample, and units of work per call.
+        long long iterations;
+        int operations;
+        // Nanoseconds per unit of work, one for each timed sample.
+        std::vector<double> samples;
+    };
+
+    class IBenchSuite {
+        std::string name_;
+        std::string filter_;
+        int repetitions_;
+        std::vector<BenchResult>* results_;
+    protected:
+        // Time body, which does `operations` units of work each time it is called,
+        // and record it as "Suite/name".  Nothing is run unless that passes the filter.
+        void measure_(std::string name, std::function<void()> body, int operations = 1);
+
+        // Whether measure_ would run the named benchmark; for skipping costly setup.
+        bool wanted_(std::string name) const;
+
+        virtual void runBenchmarks_() = 0;
+
+        IBenchSuite(std::string name):
+        name_(name),
+        repetitions_(0),
+        results_(nullptr)
+        { }
+
+    public:
+        IBenchSuite(const IBenchSuite&) = delete;
+        IBenchSuite& operator=(const IBenchSuite&) = delete;
+        virtual ~IBenchSuite() {
+            results_ = nullptr;
+        }
+
+        std::string name() const { return name_; }
+        void runBenchmarks(std::string filter, int repetitions, std::vector<BenchResult>& results) {
+            filter_ = filter;
+            repetitions_ = repetitions;
+            results_ = &results;
+            runBenchmarks_();
+            results_ = nullptr;
+        }
+    };
+}
+
+#endif /* defined(__archetype__IBenchSuite__) */
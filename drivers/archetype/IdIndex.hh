@@ -70,6 +70,19 @@ namespace archetype {
             }
         }
 
+        // Put back an object removed from the given index, which must still be free.
+        void restore(int obj_index, const T& obj) {
+            if (size_t(obj_index) >= registry_.size()) {
+                holes_ += obj_index - static_cast<int>(registry_.size());
+                registry_.resize(obj_index + 1, sentinel_);
+            } else {
+                assert(registry_[obj_index] == sentinel_);
+                holes_--;
+            }
+            registry_[obj_index] = obj;
+            index_[obj] = obj_index;
+        }
+
         int count() const {
             return static_cast<int>(registry_.size());
         }
@@ -105,8 +118,13 @@ namespace archetype {
             int total_entries = static_cast<int>(registry_.size());
             int indexed_entries = static_cast<int>(index_.size());
             out << total_entries << indexed_entries;
-            for (auto const& entry : index_) {
-                out << entry.second << entry.first;
+            // Written in index order rather than map order, which for pointers would
+            // be address order, so that equal contents always serialize identically.
+            for (int ii = 0; ii < total_entries; ++ii) {
+                auto where = index_.find(registry_[ii]);
+                if (where != index_.end() and where->second == ii) {
+                    out << ii << registry_[ii];
+                }
             }
         }
 
@@ -0,0 +1,192 @@
+//
+//  ModuleCache.cc
+//  archetype
+//
+//
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <iomanip>
+
+#include "ModuleCache.hh"
+#include "Universe.hh"
+#include "Wellspring.hh"
+#include "FileStorage.hh"
+
+using namespace std;
+
+namespace archetype {
+
+    // Bump whenever the serialized form of the Universe changes.
+    const int FragmentVersion = 3;
+
+    ModuleCache* ModuleCache::instance_ = nullptr;
+
+    ModuleCache& ModuleCache::instance() {
+        if (not instance_) {
+            instance_ = new ModuleCache;
+        }
+        return *instance_;
+    }
+
+    void ModuleCache::destroy() {
+        delete instance_;
+        instance_ = nullptr;
+    }
+
+    ModuleCache::ModuleCache():
+    hits_{0},
+    misses_{0}
+    { }
+
+    ModuleCache::~ModuleCache() {
+    }
+
+    void ModuleCache::setDirectory(std::string directory) {
+        directory_ = directory;
+        frames_.clear();
+        if (not directory_.empty()) {
+            // An existing directory is the usual case; any real failure shows up
+            // later as fragments that cannot be written.
+            mkdir(directory_.c_str(), 0755);
+        }
+    }
+
+    string ModuleCache::hash(const string& bytes) {
+        // 64-bit FNV-1a
+        uint64_t h = 14695981039346656037ULL;
+        for (unsigned char ch : bytes) {
+            h ^= ch;
+            h *= 1099511628211ULL;
+        }
+        ostringstream out;
+        out << hex << setw(16) << setfill('0') << h;
+        return out.str();
+    }
+
+    string ModuleCache::contentHash(string path) {
+        ifstream in(path.c_str(), ios::in | ios::binary);
+        string bytes{istreambuf_iterator<char>{in}, istreambuf_iterator<char>{}};
+        return hash(bytes);
+    }
+
+    Storage& operator<<(Storage& out, const ModuleCache::Dependency& d) {
+        return out << d.name << d.path << d.hash;
+    }
+
+    Storage& operator>>(Storage& in, ModuleCache::Dependency& d) {
+        return in >> d.name >> d.path >> d.hash;
+    }
+
+    string ModuleCache::fragmentPath_(string key) const {
+        string path = directory_;
+        if (path.rfind('/') != path.size() - 1) {
+            path += '/';
+        }
+        return path + key + ".acm";
+    }
+
+    void ModuleCache::depends_(const Dependency& dependency) {
+        for (auto& frame : frames_) {
+            frame.dependencies.push_back(dependency);
+        }
+    }
+
+    void ModuleCache::begin_(string key, bool cacheable) {
+        if (not cacheable) {
+            // Nothing enclosing this include can be cached either.
+            for (auto& frame : frames_) {
+                frame.cacheable = false;
+            }
+        }
+        frames_.push_back(Frame{key, cacheable, {}});
+    }
+
+    bool ModuleCache::link(string source_name) {
+        if (not enabled()) {
+            return false;
+        }
+        Dependency dependency{source_name, Wellspring::instance().locate(source_name), ""};
+        if (Wellspring::instance().wasPut(source_name) or dependency.path.empty()) {
+            begin_("", false);
+            return false;
+        }
+        dependency.hash = contentHash(dependency.path);
+
+        Universe& u = Universe::instance();
+        MemoryStorage state;
+        state << u << dependency;
+        string key = hash(string(state.bytes().begin(), state.bytes().end()));
+
+        InFileStorage fragment(fragmentPath_(key));
+        if (fragment.ok() and fragment.remaining() > 0) {
+            int version, entries;
+            fragment >> version;
+            if (version == FragmentVersion) {
+                fragment >> entries;
+                vector<Dependency> dependencies(entries);
+                bool current = true;
+                for (auto& d : dependencies) {
+                    fragment >> d;
+                    current = current and
+                        Wellspring::instance().locate(d.name) == d.path and
+                        contentHash(d.path) == d.hash;
+                }
+                if (current) {
+                    fragment >> u;
+                    for (auto const& d : dependencies) {
+                        depends_(d);
+                    }
+                    hits_++;
+                    return true;
+                }
+            }
+        }
+        misses_++;
+        begin_(key, true);
+        depends_(dependency);
+        return false;
+    }
+
+    void ModuleCache::compiled() {
+        if (not enabled() or frames_.empty()) {
+            return;
+        }
+        Frame frame = std::move(frames_.back());
+        frames_.pop_back();
+        if (not frame.cacheable) {
+            return;
+        }
+        Universe& u = Universe::instance();
+        // Write under a temporary name and rename it into place, so that a concurrent
+        // build never links a partially written fragment.
+        string path = fragmentPath_(frame.key);
+        string temporary = path + "." + to_string(getpid());
+        {
+            OutFileStorage out(temporary);
+            if (not out.ok()) {
+                return;
+            }
+            out << FragmentVersion;
+            out << static_cast<int>(frame.dependencies.size());
+            for (auto const& d : frame.dependencies) {
+                out << d;
+            }
+            out << u;
+        }
+        rename(temporary.c_str(), path.c_str());
+    }
+
+    void ModuleCache::abandoned() {
+        if (enabled() and not frames_.empty()) {
+            frames_.pop_back();
+        }
+    }
+
+}
@@ -0,0 +1,82 @@
+//
+//  ModuleCache.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__ModuleCache__
+#define __archetype__ModuleCache__
+
+#include <string>
+#include <vector>
+
+#include "Serialization.hh"
+
+namespace archetype {
+
+    // A directory of compiled include files ("fragments").  Every identifier, message,
+    // text literal and object is numbered in the order it was first seen, so a fragment
+    // can only be linked into a Universe that is in exactly the state the include was
+    // originally compiled from.  The key of a fragment is therefore the hash of that
+    // state together with the content hash of the include; the fragment also carries a
+    // manifest of the nested includes it pulled in, which are checked before linking.
+    class ModuleCache {
+    public:
+        static ModuleCache& instance();
+        static void destroy();
+
+        // Directory where fragments are kept.  Empty, the default, disables the cache.
+        std::string directory() const { return directory_; }
+        void setDirectory(std::string directory);
+        bool enabled() const { return not directory_.empty(); }
+
+        // Called by Universe::make upon `include "source_name"`.  Returns true if a
+        // fragment was linked into the Universe, in which case the include must not be
+        // compiled.  Otherwise the include is to be compiled, and exactly one of
+        // compiled() or abandoned() must follow.
+        bool link(std::string source_name);
+        void compiled();
+        void abandoned();
+
+        int hits() const { return hits_; }
+        int misses() const { return misses_; }
+
+        static std::string hash(const std::string& bytes);
+        static std::string contentHash(std::string path);
+
+    private:
+        struct Dependency {
+            std::string name;
+            std::string path;
+            std::string hash;
+        };
+
+        struct Frame {
+            std::string key;
+            bool cacheable;
+            std::vector<Dependency> dependencies;
+        };
+
+        std::string directory_;
+        std::vector<Frame> frames_;
+        int hits_;
+        int misses_;
+
+        static ModuleCache* instance_;
+
+        ModuleCache();
+        ModuleCache(const ModuleCache&) = delete;
+        ModuleCache& operator=(const ModuleCache&) = delete;
+        ~ModuleCache();
+
+        std::string fragmentPath_(std::string key) const;
+        void depends_(const Dependency& dependency);
+        void begin_(std::string key, bool cacheable);
+
+        friend Storage& operator<<(Storage& out, const Dependency& d);
+        friend Storage& operator>>(Storage& in, Dependency& d);
+    };
+
+}
+
+#endif /* defined(__archetype__ModuleCache__) */
@@ -0,0 +1,92 @@
+//
+//  NodePool.cc
+//  archetype
+//
+//
+
+#include <new>
+
+#include "NodePool.hh"
+
+using namespace std;
+
+namespace archetype {
+
+    NodePool* NodePool::instance_ = nullptr;
+
+    NodePool& NodePool::instance() {
+        if (not instance_) {
+            instance_ = new NodePool;
+        }
+        return *instance_;
+    }
+
+    void NodePool::destroy() {
+        // Nodes still alive keep their chunks, so the pool stays until they go.
+        if (instance_ and instance_->live_ == 0) {
+            delete instance_;
+            instance_ = nullptr;
+        }
+    }
+
+    NodePool::NodePool():
+    next_{nullptr},
+    end_{nullptr},
+    free_{},
+    live_{0}
+    { }
+
+    NodePool::~NodePool() {
+        releaseChunks_();
+    }
+
+    void NodePool::releaseChunks_() {
+        for (char* chunk : chunks_) {
+            ::operator delete(chunk);
+        }
+        chunks_.clear();
+        next_ = end_ = nullptr;
+        for (auto& slot : free_) {
+            slot = nullptr;
+        }
+    }
+
+    void* NodePool::allocate(size_t size) {
+        if (size == 0 or size > LargestNode) {
+            return ::operator new(size);
+        }
+        size_t size_class = (size - 1) / Granularity;
+        live_++;
+        if (FreeSlot* slot = free_[size_class]) {
+            free_[size_class] = slot->next;
+            return slot;
+        }
+        size_t rounded = (size_class + 1) * Granularity;
+        if (size_t(end_ - next_) < rounded) {
+            // Whatever is left of the current chunk is too small for any node that
+            // wants it, and is simply abandoned.
+            chunks_.push_back(static_cast<char*>(::operator new(ChunkSize)));
+            next_ = chunks_.back();
+            end_ = next_ + ChunkSize;
+        }
+        void* node = next_;
+        next_ += rounded;
+        return node;
+    }
+
+    void NodePool::release(void* node, size_t size) {
+        if (size == 0 or size > LargestNode) {
+            ::operator delete(node);
+            return;
+        }
+        if (--live_ == 0) {
+            releaseChunks_();
+            return;
+        }
+        size_t size_class = (size - 1) / Granularity;
+        FreeSlot* slot = static_cast<FreeSlot*>(node);
+        slot->next = free_[size_class];
+        free_[size_class] = slot;
+    }
+
+}
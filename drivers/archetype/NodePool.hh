@@ -0,0 +1,66 @@
+//
+//  NodePool.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__NodePool__
+#define __archetype__NodePool__
+
+#include <cstddef>
+#include <vector>
+
+namespace archetype {
+
+    // Where the nodes of compiled Expression and Statement trees live.  A program is
+    // parsed or loaded all at once and then kept until the Universe goes, so rather
+    // than asking the heap for each node, nodes are carved in turn out of large
+    // chunks:  the nodes of a method end up next to one another in memory, and
+    // building a tree costs one heap allocation per chunk rather than per node.
+    //
+    // Nodes are still owned and deleted one at a time, through the usual unique_ptrs.
+    // A deleted node's slot is reused by the next node of the same size class, and
+    // once no node is left at all, as when the Universe is destroyed or reloaded,
+    // the chunks themselves go back to the heap.
+    class NodePool {
+    public:
+        static NodePool& instance();
+        static void destroy();
+
+        void* allocate(std::size_t size);
+        void release(void* node, std::size_t size);
+
+        // Nodes allocated and not yet released.
+        long long live() const { return live_; }
+        std::size_t chunks() const { return chunks_.size(); }
+
+    private:
+        // Nodes up to this size come from the pool, in size classes this far apart;
+        // anything larger goes straight to the heap.
+        static const std::size_t Granularity = 16;
+        static const std::size_t LargestNode = 256;
+        static const std::size_t ChunkSize = 64 * 1024;
+
+        struct FreeSlot {
+            FreeSlot* next;
+        };
+
+        std::vector<char*> chunks_;
+        char* next_;
+        char* end_;
+        FreeSlot* free_[LargestNode / Granularity];
+        long long live_;
+
+        static NodePool* instance_;
+
+        NodePool();
+        NodePool(const NodePool&) = delete;
+        NodePool& operator=(const NodePool&) = delete;
+        ~NodePool();
+
+        void releaseChunks_();
+    };
+
+}
+
+#endif /* defined(__archetype__NodePool__) */
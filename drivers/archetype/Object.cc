@@ -11,7 +11,11 @@
 #include <sstream>
 
 #include "Object.hh"
+#include "ComputedAttributes.hh"
 #include "Universe.hh"
+#include "Profiler.hh"
+#include "Trace.hh"
+#include "TurnLimits.hh"
 
 using namespace std;
 
@@ -19,39 +23,123 @@ namespace archetype {
 
     bool Object::Debug = false;
 
-    ObjectPtr Object::parent() const {
+    const Object* Object::parentObject_() const {
         if (parentId_ < 0) {
             return nullptr;
-        } else {
+        }
+        if (not parent_ or parent_->id() != parentId_) {
             ObjectPtr obj = Universe::instance().getObject(parentId_);
-            return (obj and obj->isPrototype()) ? obj : nullptr;
+            parent_ = (obj and obj->isPrototype()) ? obj : nullptr;
+        }
+        return parent_.get();
+    }
+
+    ObjectPtr Object::parent() const {
+        return parentObject_() ? parent_ : nullptr;
+    }
+
+    const IExpression* Object::findAttribute(int attribute_id) const {
+        for (const Object* obj = this; obj; obj = obj->parentObject_()) {
+            auto where = obj->attributes_.find(attribute_id);
+            if (where != obj->attributes_.end()) {
+                return where->second.get();
+            }
+            if (obj->isUnset_(attribute_id)) {
+                return nullptr;
+            }
         }
+        return nullptr;
     }
 
     bool Object::hasAttribute(int attribute_id) const {
-        ObjectPtr p = parent();
-        return attributes_.count(attribute_id) > 0 or (p and p->hasAttribute(attribute_id));
+        for (const Object* obj = this; obj; obj = obj->parentObject_()) {
+            if (obj->attributes_.count(attribute_id) or obj->isUnset_(attribute_id)) {
+                return true;
+            }
+        }
+        return false;
     }
 
-    Value Object::getAttributeValue(int attribute_id) const {
-        auto where = attributes_.find(attribute_id);
-        if (where != attributes_.end()) {
-            return where->second->evaluate();
+    void Object::markUnset(int attribute_id) {
+        if (not hasAttribute(attribute_id)) {
+            unset_.insert(attribute_id);
+            if (UndoHistory::Recording) {
+                Universe::instance().History.unsetMarked(id_, attribute_id);
+            }
+            // Self now has the attribute, for an identifier that names it.
+            ComputedAttributes::instance().attributeWritten(attribute_id);
         }
-        ObjectPtr p = parent();
-        if (p) {
-            return p->getAttributeValue(attribute_id);
+    }
+
+    Value Object::getAttributeValue(int attribute_id) const {
+        if (const IExpression* attribute = findAttribute(attribute_id)) {
+            return attribute->evaluate();
         } else {
             return Value{new UndefinedValue};
         }
     }
 
     void Object::setAttribute(int attribute_id, Expression expr) {
-        attributes_[attribute_id] = std::move(expr);
+        Expression& attribute = attributes_[attribute_id];
+        bool was_unset = isUnset_(attribute_id) and unset_.erase(attribute_id);
+        if (UndoHistory::Recording) {
+            Universe::instance().History.attributeChanged(id_, attribute_id, std::move(attribute), was_unset);
+        }
+        attribute = std::move(expr);
+        ComputedAttributes::instance().attributeWritten(attribute_id);
     }
 
     void Object::setAttribute(int attribute_id, Value val) {
-        attributes_[attribute_id] = Expression(new ValueExpression(std::move(val)));
+        setAttribute(attribute_id, Expression(new ValueExpression(std::move(val))));
+    }
+
+    bool Object::appendToAttribute(int attribute_id, const std::string& text) {
+        auto where = attributes_.find(attribute_id);
+        if (where == attributes_.end()) {
+            return false;
+        }
+        auto value_expr = dynamic_cast<ValueExpression*>(where->second.get());
+        if (not value_expr) {
+            return false;
+        }
+        // The text grows where it is, so undoing needs a copy of it as it was.
+        Expression previous;
+        if (UndoHistory::Recording) {
+            if (auto text_s = dynamic_cast<const StringValue*>(value_expr->value().get())) {
+                previous.reset(new ValueExpression{Value{new StringValue{text_s->getString()}}});
+            }
+        }
+        if (value_expr->appendInPlace(text)) {
+            if (previous) {
+                Universe::instance().History.attributeChanged(id_, attribute_id, std::move(previous));
+            }
+            ComputedAttributes::instance().attributeWritten(attribute_id);
+            return true;
+        }
+        return false;
+    }
+
+    void Object::bindIdentifiers() {
+        for (auto& attribute : attributes_) {
+            bind_identifiers(attribute.second);
+        }
+        for (auto& method : methods_) {
+            method.second->bindIdentifiers();
+        }
+    }
+
+    void Object::gatherReferences(References& refs) const {
+        if (parentId_ >= 0) {
+            refs.objects.insert(parentId_);
+        }
+        for (auto const& attribute : attributes_) {
+            refs.identifiers.insert(attribute.first);
+            attribute.second->gatherReferences(refs);
+        }
+        refs.identifiers.insert(unset_.begin(), unset_.end());
+        for (auto const& method : methods_) {
+            method.second->gatherReferences(refs);
+        }
     }
 
     Value Object::send(ObjectPtr target, Value message) {
@@ -59,51 +147,138 @@ namespace archetype {
         c->senderObject = c->selfObject;
         c->selfObject = target;
         c->messageValue = std::move(message);
+        ARCHETYPE_TRACE(Trace::SEND, target->id(), c->senderObject ? c->senderObject->id() : -1);
         return target->dispatch();
     }
 
     Value Object::pass(ObjectPtr target, Value message) {
         ContextScope c;
         c->messageValue = std::move(message);
+        ARCHETYPE_TRACE(Trace::PASS, target->id(), c->selfObject ? c->selfObject->id() : -1);
         return target->dispatch();
     }
 
-    Value Object::dispatch() {
-        Value defined_message = Universe::instance().currentContext().messageValue->messageConversion();
-        Value absence{new AbsentValue};
-        Value result{new AbsentValue};
-        if (defined_message->isDefined()) {
-            if (Debug) {
-                ostringstream out;
+    namespace {
+        // The send or pass a method ended with, waiting for dispatch() to deliver it.
+        struct TailSend {
+            bool pending;
+            bool pass;
+            ObjectPtr target;
+            Value message;
+        };
+
+        TailSend PendingTailSend{false, false, nullptr, nullptr};
+
+        Value leave_tail_send(ObjectPtr target, Value message, bool pass) {
+            assert(not PendingTailSend.pending);
+            PendingTailSend.pending = true;
+            PendingTailSend.pass = pass;
+            PendingTailSend.target = std::move(target);
+            PendingTailSend.message = std::move(message);
+            // Never seen: dispatch() replaces it with the result of the send.
+            return Value{new UndefinedValue};
+        }
+
+        void debug_dispatch(const Object& target, const Value* message) {
+            ostringstream out;
+            if (message) {
                 out << "dispatching ";
-                defined_message->display(out);
+                (*message)->display(out);
                 out << " to ";
-                ObjectValue target{id()};
-                target.display(out);
-                Universe::instance().output()->put(out.str());
-                Universe::instance().output()->endLine();
+            } else {
+                out << "dispatching default method to ";
             }
-            int message_id = defined_message->getMessage();
-            result = executeMethod(message_id);
+            ObjectValue target_value{target.id()};
+            target_value.display(out);
+            Universe::instance().output()->put(out.str());
+            Universe::instance().output()->endLine();
         }
-        if (result->isSameValueAs(absence)) {
-            if (Debug) {
-                ostringstream out;
-                out << "dispatching default method to ";
-                ObjectValue target{id()};
-                target.display(out);
-                Universe::instance().output()->put(out.str());
-                Universe::instance().output()->endLine();
+    }
+
+    Value Object::tailSend(ObjectPtr target, Value message) {
+        return leave_tail_send(std::move(target), std::move(message), false);
+    }
+
+    Value Object::tailPass(ObjectPtr target, Value message) {
+        return leave_tail_send(std::move(target), std::move(message), true);
+    }
+
+    Value Object::dispatch() {
+        Value absence{new AbsentValue};
+        // One level of sending however many tail sends are delivered here, since
+        // they take no more of the native stack.
+        SendDepthScope depth;
+        Object* target = this;
+        // Keeps the target of a tail send alive, in case it destroys itself.
+        ObjectPtr tail_target;
+        Value result;
+        // Each time around is one method, in the frame the sender set up.  A method
+        // that ends with a send or pass hands the frame on to the recipient.
+        while (true) {
+            Value defined_message = Universe::instance().currentContext().messageValue->messageConversion();
+            int message_id = defined_message->isDefined() ? defined_message->getMessage() : -1;
+            bool tail = false;
+            {
+                ProfileScope profile{*target, message_id};
+                ARCHETYPE_TRACE(Trace::DISPATCH, target->id(), message_id);
+                result = Value{new AbsentValue};
+                if (defined_message->isDefined()) {
+                    if (Debug) {
+                        debug_dispatch(*target, &defined_message);
+                    }
+                    result = target->executeMethod(message_id);
+                    if (PendingTailSend.pending) {
+                        if (not target->hasDefaultMethod()) {
+                            tail = true;
+                        } else {
+                            // Should the message find no method, this object's default
+                            // method is still to run, so the frame cannot be handed on.
+                            TailSend pending = std::move(PendingTailSend);
+                            PendingTailSend.pending = false;
+                            result = pending.pass ?
+                                pass(std::move(pending.target), std::move(pending.message)) :
+                                send(std::move(pending.target), std::move(pending.message));
+                        }
+                    }
+                }
+                if (not tail and result->isSameValueAs(absence)) {
+                    if (Debug) {
+                        debug_dispatch(*target, nullptr);
+                    }
+                    result = target->executeDefaultMethod();
+                    tail = PendingTailSend.pending;
+                }
+            }
+            if (not tail) {
+                return result;
             }
-            result = executeDefaultMethod();
+            TailSend pending = std::move(PendingTailSend);
+            PendingTailSend.pending = false;
+            Universe::Context& c = Universe::instance().currentContext();
+            if (not pending.pass) {
+                c.senderObject = c.selfObject;
+                c.selfObject = pending.target;
+            }
+            c.messageValue = std::move(pending.message);
+            ObjectPtr from = pending.pass ? c.selfObject : c.senderObject;
+            ARCHETYPE_TRACE(pending.pass ? Trace::PASS : Trace::SEND, pending.target->id(), from ? from->id() : -1);
+            tail_target = std::move(pending.target);
+            target = tail_target.get();
         }
-        return result;
+    }
+
+    bool Object::hasDefaultMethod() const {
+        if (not methods_.empty() and methods_.rbegin()->first == DefaultMethod) {
+            return true;
+        }
+        ObjectPtr p = parent();
+        return p and p->hasDefaultMethod();
     }
 
     Value Object::executeMethod(int message_id) {
         auto where = methods_.find(message_id);
         if (where != methods_.end()) {
-            return where->second->execute();
+            return execute_statement(where->second);
         }
         ObjectPtr p = parent();
         if (p) {
@@ -117,7 +292,7 @@ namespace archetype {
         Value obj{new ObjectValue{id()}};
         if (methods_.size() > 0  and  methods_.rbegin()->first == DefaultMethod) {
             auto defaultMethod = methods_.rbegin();
-            return defaultMethod->second->execute();
+            return execute_statement(defaultMethod->second);
         }
         ObjectPtr p = parent();
         if (p) {
@@ -128,6 +303,7 @@ namespace archetype {
     }
 
     void Object::setMethod(int message_id, Statement stmt) {
+        stmt->markTail();
         methods_[message_id] = std::move(stmt);
     }
 
@@ -137,6 +313,10 @@ namespace archetype {
         for (auto const& attribute : attributes_) {
             out << attribute.first << attribute.second;
         }
+        out << static_cast<int>(unset_.size());
+        for (int attribute_id : unset_) {
+            out << attribute_id;
+        }
         out << static_cast<int>(methods_.size());
         for (auto const& method : methods_) {
             out << method.first << method.second;
@@ -158,6 +338,19 @@ namespace archetype {
             attributes_[attribute_id] = std::move(expr);
         }
 
+        // Before version 2, an attribute read while unset was assigned UNDEFINED
+        // instead, so is among the attributes.
+        int unset_entries = 0;
+        if (Universe::instance().readingVersion() >= 2) {
+            in >> unset_entries;
+        }
+        unset_.clear();
+        for (int i = 0; i < unset_entries; ++i) {
+            int attribute_id;
+            in >> attribute_id;
+            unset_.insert(attribute_id);
+        }
+
         int method_entries;
         in >> method_entries;
         methods_.clear();
@@ -165,6 +358,7 @@ namespace archetype {
             int message_id;
             Statement stmt;
             in >> message_id >> stmt;
+            stmt->markTail();
             methods_[message_id] = std::move(stmt);
         }
     }
@@ -13,6 +13,8 @@
 #include <memory>
 #include <iostream>
 #include <limits>
+#include <set>
+#include <string>
 
 #include "Expression.hh"
 #include "Statement.hh"
@@ -26,14 +28,28 @@ namespace archetype {
     class Object;
     typedef std::shared_ptr<Object> ObjectPtr;
 
+    struct StripReport;
+
     class Object {
         int parentId_;
         int id_;
         bool prototype_;
         std::map<int, Expression> attributes_;
         std::map<int, Statement> methods_;
+        // Attributes read here when neither this object nor any parent held them.
+        // Each reads as UNDEFINED from then on, as though assigned it, but costs no
+        // expression and is not a change to undo.
+        std::set<int> unset_;
+        // The parent last found under parentId_.  Destroying an object gives it an
+        // invalid id, so a parent kept past that is looked up again.
+        mutable ObjectPtr parent_;
+
+        const Object* parentObject_() const;
+        bool isUnset_(int attribute_id) const { return not unset_.empty() and unset_.count(attribute_id) > 0; }
 
         friend void inspect_universe(Storage& in, std::ostream& out);
+        friend StripReport strip_universe(const std::set<std::string>& keep_messages);
+        friend class UndoHistory;
 
     public:
         static const int INVALID = -1;
@@ -62,17 +78,44 @@ namespace archetype {
         ObjectPtr parent() const;
 
         bool hasAttribute(int attribute_id) const;
+        // The attribute this object or its nearest ancestor holds, or nullptr when
+        // none does or the nearest only ever had it read; see markUnset.
+        const IExpression* findAttribute(int attribute_id) const;
+        // Note that the attribute was read here and found nowhere, so that it is
+        // UNDEFINED here from now on, whatever a parent is later given.
+        void markUnset(int attribute_id);
         Value getAttributeValue(int attribute_id) const;
         void setAttribute(int attribute_id, Expression expr);
         void setAttribute(int attribute_id, Value val);
+        // Append to the string this object itself holds in the attribute, if nothing
+        // else holds it too.  Returns whether it did.
+        bool appendToAttribute(int attribute_id, const std::string& text);
 
+        // Methods are marked as they are set, so that a send or pass that is the
+        // last thing a method does is carried out in place of the method's own frame.
         void setMethod(int message_id, Statement stmt);
 
+        // Bind the identifiers in every attribute and method; see bind_identifiers.
+        void bindIdentifiers();
+
+        // Add what this object refers to:  its parent, and whatever its attributes
+        // and methods name or hold.
+        virtual void gatherReferences(References& refs) const;
+
         static Value send(ObjectPtr target, Value message);
         static Value pass(ObjectPtr target, Value message);
 
+        // Called instead of send() and pass() by a send or pass in tail position.
+        // The message is left for dispatch() to deliver once the method returns,
+        // without another frame on the native stack.
+        static Value tailSend(ObjectPtr target, Value message);
+        static Value tailPass(ObjectPtr target, Value message);
+
         virtual Value dispatch();
 
+        // Whether a message that finds no method would still be handled here.
+        virtual bool hasDefaultMethod() const;
+
         virtual Value executeMethod(int message_id);
         virtual Value executeDefaultMethod();
 
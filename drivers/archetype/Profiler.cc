@@ -0,0 +1,191 @@
+//
+//  Profiler.cc
+//  archetype
+//
+//
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "Profiler.hh"
+#include "Object.hh"
+#include "Universe.hh"
+
+using namespace std;
+
+namespace archetype {
+    bool Profiler::Enabled = false;
+
+    Profiler* Profiler::instance_ = nullptr;
+
+    Profiler& Profiler::instance() {
+        if (not instance_) {
+            instance_ = new Profiler;
+        }
+        return *instance_;
+    }
+
+    void Profiler::destroy() {
+        delete instance_;
+        instance_ = nullptr;
+        Enabled = false;
+    }
+
+    Profiler::Profiler() {
+        // The root of every call path
+        nodes_.push_back(Node{-1, -1, 0, {}});
+    }
+
+    Profiler::~Profiler() {
+    }
+
+    void Profiler::start(string path) {
+        path_ = path;
+        Enabled = true;
+    }
+
+    void Profiler::finish() {
+        Enabled = false;
+        if (path_.empty()) {
+            return;
+        }
+        ofstream out(path_.c_str(), ios::out | ios::app);
+        if (not out) {
+            cerr << "Cannot write profile to " << path_ << endl;
+            return;
+        }
+        writeFoldedStacks(out);
+        writeSummary(cerr, 30);
+    }
+
+    int Profiler::entry_(string label) {
+        // Folded stacks use ';' between frames.
+        replace(label.begin(), label.end(), ';', ',');
+        auto found = labels_.find(label);
+        if (found != labels_.end()) {
+            return found->second;
+        }
+        int entry = static_cast<int>(entries_.size());
+        entries_.push_back(Entry{label, 0, 0, 0, 0});
+        labels_[label] = entry;
+        return entry;
+    }
+
+    void Profiler::enterDispatch(const Object& target, int message_id) {
+        // Objects made at run time have no name, so all those of one type share an
+        // entry.  The key includes the type in case an object id is reused.
+        auto key = make_tuple(target.id(), target.parentId(), message_id);
+        auto found = dispatchEntries_.find(key);
+        if (found == dispatchEntries_.end()) {
+            ostringstream label;
+            if (message_id >= 0) {
+                label << "'" << Universe::instance().Messages.get(message_id) << "'";
+            } else {
+                label << "default";
+            }
+            label << " -> ";
+            Universe& u = Universe::instance();
+            auto named = find_if(u.ObjectIdentifiers.begin(), u.ObjectIdentifiers.end(),
+                                 [&target](const pair<const int, int>& p) { return p.second == target.id(); });
+            if (named != u.ObjectIdentifiers.end()) {
+                label << u.Identifiers.get(named->first);
+            } else if (ObjectPtr parent = target.parent()) {
+                label << "<";
+                ObjectValue{parent->id()}.display(label);
+                label << ">";
+            } else {
+                label << "<null>";
+            }
+            found = dispatchEntries_.insert(make_pair(key, entry_(label.str()))).first;
+        }
+        enter_(found->second);
+    }
+
+    void Profiler::enterStatement(SourcePosition position) {
+        auto found = statementEntries_.find(position);
+        if (found == statementEntries_.end()) {
+            ostringstream label;
+            label << position;
+            found = statementEntries_.insert(make_pair(position, entry_(label.str()))).first;
+        }
+        enter_(found->second);
+    }
+
+    void Profiler::enter_(int entry) {
+        int parent = frames_.empty() ? 0 : frames_.back().node;
+        auto child = nodes_[parent].children.find(entry);
+        int node;
+        if (child != nodes_[parent].children.end()) {
+            node = child->second;
+        } else {
+            node = static_cast<int>(nodes_.size());
+            nodes_[parent].children[entry] = node;
+            nodes_.push_back(Node{entry, parent, 0, {}});
+        }
+        entries_[entry].calls++;
+        entries_[entry].active++;
+        frames_.push_back(Frame{node, Clock::now(), 0});
+    }
+
+    void Profiler::exit() {
+        if (frames_.empty()) {
+            return;
+        }
+        Frame frame = frames_.back();
+        frames_.pop_back();
+        long long elapsed = chrono::duration_cast<chrono::nanoseconds>(Clock::now() - frame.start).count();
+        long long exclusive = max(0LL, elapsed - frame.children);
+        Node& node = nodes_[frame.node];
+        node.exclusive += exclusive;
+        Entry& entry = entries_[node.entry];
+        entry.exclusive += exclusive;
+        // Only the outermost of recursive calls counts toward inclusive time.
+        if (--entry.active == 0) {
+            entry.inclusive += elapsed;
+        }
+        if (not frames_.empty()) {
+            frames_.back().children += elapsed;
+        }
+    }
+
+    void Profiler::writeFoldedStacks(ostream& out) const {
+        for (size_t n = 1; n < nodes_.size(); ++n) {
+            if (nodes_[n].exclusive == 0) {
+                continue;
+            }
+            vector<int> path;
+            for (int p = static_cast<int>(n); p > 0; p = nodes_[p].parent) {
+                path.push_back(nodes_[p].entry);
+            }
+            for (auto e = path.rbegin(); e != path.rend(); ++e) {
+                out << (e == path.rbegin() ? "" : ";") << entries_[*e].label;
+            }
+            out << ' ' << nodes_[n].exclusive << endl;
+        }
+    }
+
+    void Profiler::writeSummary(ostream& out, size_t limit) const {
+        vector<const Entry*> sorted;
+        for (auto const& entry : entries_) {
+            sorted.push_back(&entry);
+        }
+        sort(sorted.begin(), sorted.end(), [](const Entry* a, const Entry* b) {
+            return a->exclusive > b->exclusive;
+        });
+        if (sorted.size() > limit) {
+            sorted.resize(limit);
+        }
+        out << setw(10) << "calls" << setw(14) << "inclusive ms" << setw(14) << "exclusive ms"
+            << "  " << "method or statement" << endl;
+        out << fixed << setprecision(3);
+        for (const Entry* entry : sorted) {
+            out << setw(10) << entry->calls
+                << setw(14) << entry->inclusive / 1.0e6
+                << setw(14) << entry->exclusive / 1.0e6
+                << "  " << entry->label << endl;
+        }
+    }
+
+}
@@ -0,0 +1,119 @@
+//
+//  Profiler.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__Profiler__
+#define __archetype__Profiler__
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "SourceFile.hh"
+
+namespace archetype {
+
+    class Object;
+
+    // Times every method dispatch and every statement of a running program, for
+    // finding where an Archetype program spends its time.  Each method is known
+    // as 'message' -> object, and each statement by its source file and line.
+    //
+    // The profile is written as folded stacks, one line per distinct call path
+    // with the nanoseconds spent in its last frame, which is what flamegraph.pl
+    // and similar tools read.  A summary of the most expensive entries goes to
+    // the error stream.
+    class Profiler {
+    public:
+        // Checked before anything else is done, so costs a single branch when off.
+        static bool Enabled;
+
+        static Profiler& instance();
+        static void destroy();
+
+        // Start profiling; the profile is appended to the given file by finish().
+        void start(std::string path);
+        void finish();
+
+        void enterDispatch(const Object& target, int message_id);
+        void enterStatement(SourcePosition position);
+        void exit();
+
+        void writeFoldedStacks(std::ostream& out) const;
+        void writeSummary(std::ostream& out, size_t limit) const;
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        struct Entry {
+            std::string label;
+            long long calls;
+            long long inclusive;
+            long long exclusive;
+            int active;
+        };
+
+        // Call paths are kept as a tree, each node one entry called from its parent.
+        struct Node {
+            int entry;
+            int parent;
+            long long exclusive;
+            std::map<int, int> children;
+        };
+
+        struct Frame {
+            int node;
+            Clock::time_point start;
+            long long children;
+        };
+
+        std::string path_;
+        std::vector<Entry> entries_;
+        std::map<std::string, int> labels_;
+        std::map<std::tuple<int, int, int>, int> dispatchEntries_;
+        std::map<SourcePosition, int> statementEntries_;
+        std::vector<Node> nodes_;
+        std::vector<Frame> frames_;
+
+        static Profiler* instance_;
+
+        Profiler();
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+        ~Profiler();
+
+        int entry_(std::string label);
+        void enter_(int entry);
+    };
+
+    // Times its own lifetime as one dispatch or statement, if profiling is enabled.
+    class ProfileScope {
+        bool active_;
+    public:
+        ProfileScope(const Object& target, int message_id): active_{Profiler::Enabled} {
+            if (active_) {
+                Profiler::instance().enterDispatch(target, message_id);
+            }
+        }
+        ProfileScope(SourcePosition position): active_{Profiler::Enabled} {
+            if (active_) {
+                Profiler::instance().enterStatement(position);
+            }
+        }
+        ~ProfileScope() {
+            if (active_) {
+                Profiler::instance().exit();
+            }
+        }
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+    };
+
+}
+
+#endif /* defined(__archetype__Profiler__) */
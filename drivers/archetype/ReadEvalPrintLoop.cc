@@ -59,6 +59,7 @@ namespace archetype {
                     if (is_object_declaration(input_tokens.token())) {
                         input_tokens.didNotConsume();
                         if (Universe::instance().make(input_tokens)) {
+                            Universe::instance().bindIdentifiers();
                             out->put("Added to Universe.");
                             out->endLine();
                         } else {
@@ -88,6 +89,7 @@ namespace archetype {
                     }
                 }
             } catch (const std::exception& e) {
+                Universe::instance().output()->flush();
                 cout << "Exception: " << e.what() << endl;
                 errors++;
             }
@@ -7,14 +7,47 @@
 //
 
 #include <sstream>
+#include <deque>
+#include <map>
 
 #include "SourceFile.hh"
 
 using namespace std;
 
 namespace archetype {
+    static deque<string>& source_filenames() {
+        static deque<string> filenames;
+        return filenames;
+    }
+
+    static int source_file_index(const string& filename) {
+        static map<string, int> indexes;
+        auto found = indexes.find(filename);
+        if (found != indexes.end()) {
+            return found->second;
+        }
+        int index = static_cast<int>(source_filenames().size());
+        source_filenames().push_back(filename);
+        indexes[filename] = index;
+        return index;
+    }
+
+    string SourcePosition::filename() const {
+        return known() ? source_filenames()[file_] : string();
+    }
+
+    ostream& operator<<(ostream& out, const SourcePosition& position) {
+        if (position.known()) {
+            out << position.filename() << ":" << position.line();
+        } else {
+            out << "?";
+        }
+        return out;
+    }
+
     SourceFile::SourceFile(std::string source, stream_ptr& in):
     filename_{source},
+    fileIndex_{source_file_index(source)},
     file_{std::move(in)},
     fileLine_{0},
     linePos_{0},
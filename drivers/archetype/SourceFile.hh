@@ -15,8 +15,33 @@
 
 namespace archetype {
     typedef std::unique_ptr<std::istream> stream_ptr;
+
+    // Where something was compiled from.  Source file names are kept in a table
+    // that lasts the life of the program, so a position is only two integers.
+    class SourcePosition {
+        int file_;
+        int line_;
+    public:
+        SourcePosition(): file_{-1}, line_{0} { }
+        SourcePosition(int file, int line): file_{file}, line_{line} { }
+
+        bool known() const { return file_ >= 0; }
+        int file() const { return file_; }
+        int line() const { return line_; }
+        std::string filename() const;
+
+        bool operator==(const SourcePosition& other) const {
+            return file_ == other.file_ and line_ == other.line_;
+        }
+        bool operator<(const SourcePosition& other) const {
+            return file_ < other.file_ or (file_ == other.file_ and line_ < other.line_);
+        }
+    };
+
+    std::ostream& operator<<(std::ostream& out, const SourcePosition& position);
     class SourceFile {
         std::string filename_;
+        int fileIndex_;
         stream_ptr file_;
         int fileLine_;
         std::string lineBuffer_;
@@ -30,6 +55,7 @@ namespace archetype {
         char readChar();
         void unreadChar(char ch);
         void showPosition(std::ostream& out);
+        SourcePosition position() const { return SourcePosition{fileIndex_, fileLine_}; }
     };
 
     typedef std::shared_ptr<SourceFile> SourceFilePtr;
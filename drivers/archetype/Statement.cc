@@ -33,10 +33,23 @@ namespace archetype {
 
     bool IStatement::Debug = false;
 
+    void CompoundStatement::gatherReferences(References& refs) const {
+        for (auto const& stmt : statements_) {
+            stmt->gatherReferences(refs);
+        }
+    }
+
+    void CompoundStatement::bindIdentifiers() {
+        for (auto& stmt : statements_) {
+            stmt->bindIdentifiers();
+        }
+    }
+
     void CompoundStatement::read(Storage& in) {
         int count;
         in >> count;
         statements_.clear();
+        statements_.reserve(count);
         for (int i = 0; i < count; ++i) {
             Statement stmt;
             in >> stmt;
@@ -86,7 +99,7 @@ namespace archetype {
         Value break_v{new BreakValue};
         Value result{new UndefinedValue};
         for (auto const& stmt : statements_) {
-            result = stmt->execute();
+            result = execute_statement(stmt);
             if (result->isSameValueAs(break_v)) {
                 // Break statements stop a compound statement, but the result must be propagated up
                 // to the containing loop, which consumes it.
@@ -96,6 +109,20 @@ namespace archetype {
         return result;
     }
 
+    void CompoundStatement::markTail() {
+        if (not statements_.empty()) {
+            statements_.back()->markTail();
+        }
+    }
+
+    void ExpressionStatement::gatherReferences(References& refs) const {
+        expression_->gatherReferences(refs);
+    }
+
+    void ExpressionStatement::bindIdentifiers() {
+        bind_identifiers(expression_);
+    }
+
     void ExpressionStatement::read(Storage& in) {
         in >> expression_;
     }
@@ -117,12 +144,35 @@ namespace archetype {
         if (auto val_expr = dynamic_cast<ValueExpression*>(expression_.get())) {
             Value val = val_expr->evaluate();
             if (dynamic_cast<MessageValue*>(val.get())) {
-                return Object::pass(Universe::instance().currentContext().selfObject, std::move(val));
+                ObjectPtr self = Universe::instance().currentContext().selfObject;
+                if (tail_ and not IExpression::Debug) {
+                    return Object::tailPass(std::move(self), std::move(val));
+                }
+                return Object::pass(std::move(self), std::move(val));
             }
         }
+        if (tail_ and not IExpression::Debug) {
+            return expression_->evaluateTail()->valueConversion();
+        }
         return expression_->evaluate()->valueConversion();
     }
 
+    void IfStatement::gatherReferences(References& refs) const {
+        condition_->gatherReferences(refs);
+        thenBranch_->gatherReferences(refs);
+        if (elseBranch_) {
+            elseBranch_->gatherReferences(refs);
+        }
+    }
+
+    void IfStatement::bindIdentifiers() {
+        bind_identifiers(condition_);
+        thenBranch_->bindIdentifiers();
+        if (elseBranch_) {
+            elseBranch_->bindIdentifiers();
+        }
+    }
+
     void IfStatement::read(Storage& in) {
         in >> condition_ >> thenBranch_;
         int has_else;
@@ -155,6 +205,13 @@ namespace archetype {
         return true;
     }
 
+    void IfStatement::markTail() {
+        thenBranch_->markTail();
+        if (elseBranch_) {
+            elseBranch_->markTail();
+        }
+    }
+
     void IfStatement::display(std::ostream &out) const {
         out << "if ";
         condition_->prefixDisplay(out);
@@ -185,9 +242,9 @@ namespace archetype {
         }
         Value result;
         if (true_enough) {
-            result = thenBranch_->execute();
+            result = execute_statement(thenBranch_);
         } else if (elseBranch_){
-            result = elseBranch_->execute();
+            result = execute_statement(elseBranch_);
         } else {
             result = Value{new UndefinedValue};
         }
@@ -201,11 +258,34 @@ namespace archetype {
         return result;
     }
 
+    void CaseStatement::gatherReferences(References& refs) const {
+        testExpression_->gatherReferences(refs);
+        for (auto const& case_pair : cases_) {
+            case_pair.match->gatherReferences(refs);
+            case_pair.action->gatherReferences(refs);
+        }
+        if (defaultCase_) {
+            defaultCase_->gatherReferences(refs);
+        }
+    }
+
+    void CaseStatement::bindIdentifiers() {
+        bind_identifiers(testExpression_);
+        for (auto& case_pair : cases_) {
+            bind_identifiers(case_pair.match);
+            case_pair.action->bindIdentifiers();
+        }
+        if (defaultCase_) {
+            defaultCase_->bindIdentifiers();
+        }
+    }
+
     void CaseStatement::read(Storage& in) {
         in >> testExpression_;
         int entries;
         in >> entries;
         cases_.clear();
+        cases_.reserve(entries);
         for (int i = 0; i < entries; ++i) {
             Case case_pair;
             in >> case_pair.match >> case_pair.action;
@@ -292,6 +372,15 @@ namespace archetype {
         out << "}";
     }
 
+    void CaseStatement::markTail() {
+        for (auto& case_pair : cases_) {
+            case_pair.action->markTail();
+        }
+        if (defaultCase_) {
+            defaultCase_->markTail();
+        }
+    }
+
     Value CaseStatement::execute() const {
         Value test_value = testExpression_->evaluate()->valueConversion();
         for (auto const& case_pair : cases_) {
@@ -305,7 +394,7 @@ namespace archetype {
                     Universe::instance().output()->put(out.str());
                     Universe::instance().output()->endLine();
                 }
-                return case_pair.action->execute();
+                return execute_statement(case_pair.action);
             }
         }
         if (defaultCase_) {
@@ -316,11 +405,20 @@ namespace archetype {
                 Universe::instance().output()->put(out.str());
                 Universe::instance().output()->endLine();
             }
-            return defaultCase_->execute();
+            return execute_statement(defaultCase_);
         }
         return Value{new UndefinedValue};
     }
 
+    void CreateStatement::gatherReferences(References& refs) const {
+        refs.objects.insert(typeId_);
+        target_->gatherReferences(refs);
+    }
+
+    void CreateStatement::bindIdentifiers() {
+        bind_identifiers(target_);
+    }
+
     void CreateStatement::read(Storage& in) {
         in >> typeId_ >> target_;
     }
@@ -381,6 +479,14 @@ namespace archetype {
         return result;
     }
 
+    void DestroyStatement::gatherReferences(References& refs) const {
+        victim_->gatherReferences(refs);
+    }
+
+    void DestroyStatement::bindIdentifiers() {
+        bind_identifiers(victim_);
+    }
+
     void DestroyStatement::read(Storage& in) {
         in >> victim_;
     }
@@ -412,6 +518,18 @@ namespace archetype {
         return Value{new UndefinedValue};
     }
 
+    void OutputStatement::gatherReferences(References& refs) const {
+        for (auto const& expr : expressions_) {
+            expr->gatherReferences(refs);
+        }
+    }
+
+    void OutputStatement::bindIdentifiers() {
+        for (auto& expr : expressions_) {
+            bind_identifiers(expr);
+        }
+    }
+
     void OutputStatement::read(Storage& in) {
         int write_type_as_int;
         in >> write_type_as_int;
@@ -419,6 +537,7 @@ namespace archetype {
         int entries;
         in >> entries;
         expressions_.clear();
+        expressions_.reserve(entries);
         for (int i = 0; i < entries; ++i) {
             Expression expr;
             in >> expr;
@@ -500,6 +619,17 @@ namespace archetype {
         return last_value;
     }
 
+    // Enough for the usual handful of starting cursors at one or two widths.
+    const size_t MaxParagraphRenderings = 8;
+
+    void ParagraphOutputStatement::gatherReferences(References& refs) const {
+        refs.textLiterals.insert(quoteLiterals_.begin(), quoteLiterals_.end());
+    }
+
+    void ParagraphOutputStatement::bindIdentifiers() {
+        // Quoted text names no identifiers.
+    }
+
     void ParagraphOutputStatement::read(Storage& in) {
         int entries;
         in >> entries;
@@ -510,6 +640,7 @@ namespace archetype {
             v[i] = q;
         }
         quoteLiterals_.swap(v);
+        compose_();
     }
 
     void ParagraphOutputStatement::write(Storage& out) const {
@@ -532,16 +663,13 @@ namespace archetype {
             quoteLiterals_.push_back(t.token().number());
         }
         vector<int>(quoteLiterals_).swap(quoteLiterals_);
+        compose_();
         return true;
     }
 
-    void ParagraphOutputStatement::display(std::ostream& out) const {
-        for (int q : quoteLiterals_) {
-            out << ">>" << Universe::instance().TextLiterals.get(q) << endl;
-        }
-    }
-
-    Value ParagraphOutputStatement::execute() const {
+    void ParagraphOutputStatement::compose_() {
+        text_.clear();
+        renderings_.clear();
         string prev;
         string line;
         bool in_paragraph = false;
@@ -555,29 +683,68 @@ namespace archetype {
                     auto final = *(prev.rbegin());
                     switch (final) {
                         case '.': case ':': case '!': case '?':
-                            Universe::instance().output()->put("  ");
+                            text_.push_back(TextPiece{"  ", false});
                             break;
                         default:
                             if (not isspace(final)) {
-                                Universe::instance().output()->put(" ");
+                                text_.push_back(TextPiece{" ", false});
                             }
                             break;
                     } // switch
                 } else {
-                    Universe::instance().output()->endLine();
+                    text_.back().endsLine = true;
                 }
             }
-            Universe::instance().output()->put(line);
-            if (not in_paragraph) {
-                Universe::instance().output()->endLine();
-            }
+            text_.push_back(TextPiece{line, not in_paragraph});
             prev = line;
         }
         // This is the end of the series of quote-lines.  Close out any dangling paragraph.
         if (in_paragraph) {
-            Universe::instance().output()->endLine();
+            text_.back().endsLine = true;
+        }
+        text_.shrink_to_fit();
+        lastLine_ = line;
+    }
+
+    void ParagraphOutputStatement::display(std::ostream& out) const {
+        for (int q : quoteLiterals_) {
+            out << ">>" << Universe::instance().TextLiterals.get(q) << endl;
+        }
+    }
+
+    Value ParagraphOutputStatement::execute() const {
+        UserOutput output = Universe::instance().output();
+        WrappedOutput* wrapped = dynamic_cast<WrappedOutput*>(output.get());
+        if (wrapped) {
+            auto key = make_pair(wrapped->maxColumns(), wrapped->cursor());
+            auto found = renderings_.find(key);
+            if (found == renderings_.end()) {
+                if (renderings_.size() >= MaxParagraphRenderings) {
+                    renderings_.clear();
+                }
+                found = renderings_.insert(make_pair(key, wrapped->wrap(text_))).first;
+            }
+            wrapped->putWrapped(found->second);
+        } else {
+            for (auto const& piece : text_) {
+                output->put(piece.text);
+                if (piece.endsLine) {
+                    output->endLine();
+                }
+            }
         }
-        return Value{new StringValue{line}};
+        return Value{new StringValue{lastLine_}};
+    }
+
+    void ForStatement::gatherReferences(References& refs) const {
+        refs.eachObject = true;
+        selection_->gatherReferences(refs);
+        action_->gatherReferences(refs);
+    }
+
+    void ForStatement::bindIdentifiers() {
+        bind_identifiers(selection_);
+        action_->bindIdentifiers();
     }
 
     void ForStatement::read(Storage& in) {
@@ -615,7 +782,7 @@ namespace archetype {
             c->eachObject = each_object;
             Value selectionValue = selection_->evaluate();
             if (selectionValue->isTrueEnough()) {
-                result = action_->execute();
+                result = execute_statement(action_);
                 if (IStatement::Debug) {
                     ostringstream out;
                     out << "for each = ";
@@ -649,6 +816,16 @@ namespace archetype {
         return result;
     }
 
+    void WhileStatement::gatherReferences(References& refs) const {
+        condition_->gatherReferences(refs);
+        action_->gatherReferences(refs);
+    }
+
+    void WhileStatement::bindIdentifiers() {
+        bind_identifiers(condition_);
+        action_->bindIdentifiers();
+    }
+
     void WhileStatement::read(Storage &in) {
         in >> condition_ >> action_;
     }
@@ -695,7 +872,7 @@ namespace archetype {
             if (not true_enough) {
                 break;
             }
-            result = action_->execute();
+            result = execute_statement(action_);
             if (result->isSameValueAs(break_v)) {
                 if (IExpression::Debug) {
                     Universe::instance().output()->put("break while");
@@ -739,6 +916,7 @@ namespace archetype {
             t.stopLooking();
             return the_stmt;
         }
+        SourcePosition position = t.position();
 
         if (t.token() == Token(Token::PUNCTUATION, '{')) {
             the_stmt.reset(new CompoundStatement);
@@ -783,6 +961,7 @@ namespace archetype {
             }  /* switch (t.token().number()) */
         }
 
+        the_stmt->setPosition(position);
         if (the_stmt->make(t))
             return the_stmt;
         else
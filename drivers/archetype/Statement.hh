@@ -10,16 +10,21 @@
 #define __archetype__Statement__
 
 #include <memory>
-#include <list>
 #include <vector>
+#include <map>
+#include <utility>
 
 #include "TokenStream.hh"
 #include "Expression.hh"
 #include "Serialization.hh"
+#include "WrappedOutput.hh"
+#include "Profiler.hh"
+#include "TurnLimits.hh"
 
 namespace archetype {
 
     class IStatement {
+        SourcePosition position_;
     protected:
         IStatement() { }
     public:
@@ -29,11 +34,26 @@ namespace archetype {
         IStatement& operator=(const IStatement&) = delete;
         virtual ~IStatement() { }
 
+        // Nodes are kept in the NodePool rather than allocated one by one.
+        static void* operator new(std::size_t size) { return NodePool::instance().allocate(size); }
+        static void operator delete(void* node, std::size_t size) { NodePool::instance().release(node, size); }
+
         virtual void read(Storage& in) = 0;
         virtual void write(Storage& out) const = 0;
         virtual bool make(TokenStream& t) = 0;
         virtual void display(std::ostream& out) const = 0;
         virtual Value execute() const = 0;
+        virtual void gatherReferences(References& refs) const = 0;
+        // Bind the identifiers in every expression beneath; see bind_identifiers.
+        virtual void bindIdentifiers() = 0;
+        // Note that this statement is the last a method executes, so that its
+        // value is the method's value.
+        virtual void markTail() { }
+
+        // Where the statement begins in its source.  Positions are not serialized,
+        // so they are only known in a Universe compiled in this run.
+        SourcePosition position() const { return position_; }
+        void setPosition(SourcePosition position) { position_ = position; }
     };
 
     typedef std::unique_ptr<IStatement> Statement;
@@ -42,25 +62,33 @@ namespace archetype {
     Storage& operator>>(Storage& in, Statement& stmt);
 
     class CompoundStatement : public IStatement {
-        std::list<Statement> statements_;
+        std::vector<Statement> statements_;
     public:
         virtual void read(Storage& in) override;
         virtual void write(Storage& out) const override;
         virtual bool make(TokenStream& t) override;
         virtual void display(std::ostream& out) const override;
         virtual Value execute() const override;
+        virtual void gatherReferences(References& refs) const override;
+        virtual void bindIdentifiers() override;
+        virtual void markTail() override;
 
-        const std::list<Statement>& statements() const { return statements_; }
+        const std::vector<Statement>& statements() const { return statements_; }
     };
 
     class ExpressionStatement : public IStatement {
         Expression expression_;
+        bool tail_;
     public:
+        ExpressionStatement(): tail_{false} { }
         virtual void read(Storage& in) override;
         virtual void write(Storage& out) const override;
         virtual bool make(TokenStream& t) override;
         virtual void display(std::ostream& out) const override;
         virtual Value execute() const override;
+        virtual void gatherReferences(References& refs) const override;
+        virtual void bindIdentifiers() override;
+        virtual void markTail() override { tail_ = true; }
 
         const Expression& expression() const { return expression_; }
     };
@@ -75,6 +103,9 @@ namespace archetype {
         virtual bool make(TokenStream& t) override;
         virtual void display(std::ostream& out) const override;
         virtual Value execute() const override;
+        virtual void gatherReferences(References& refs) const override;
+        virtual void bindIdentifiers() override;
+        virtual void markTail() override;
     };
 
     class CaseStatement : public IStatement {
@@ -85,7 +116,7 @@ namespace archetype {
         };
     private:
         Expression testExpression_;
-        std::list<Case> cases_;
+        std::vector<Case> cases_;
         Statement defaultCase_;
     public:
         virtual void read(Storage& in) override;
@@ -93,9 +124,12 @@ namespace archetype {
         virtual bool make(TokenStream& t) override;
         virtual void display(std::ostream& out) const override;
         virtual Value execute() const override;
+        virtual void gatherReferences(References& refs) const override;
+        virtual void bindIdentifiers() override;
+        virtual void markTail() override;
 
         const Expression& testExpression() const { return testExpression_; }
-        const std::list<Case>& cases() const { return cases_; }
+        const std::vector<Case>& cases() const { return cases_; }
     };
 
     class CreateStatement : public IStatement {
@@ -107,6 +141,8 @@ namespace archetype {
         virtual bool make(TokenStream& t) override;
         virtual void display(std::ostream& out) const override;
         virtual Value execute() const override;
+        virtual void gatherReferences(References& refs) const override;
+        virtual void bindIdentifiers() override;
     };
 
     class DestroyStatement : public IStatement {
@@ -117,6 +153,8 @@ namespace archetype {
         virtual bool make(TokenStream& t) override;
         virtual void display(std::ostream& out) const override;
         virtual Value execute() const override;
+        virtual void gatherReferences(References& refs) const override;
+        virtual void bindIdentifiers() override;
     };
 
     class ForStatement : public IStatement {
@@ -128,6 +166,8 @@ namespace archetype {
         virtual bool make(TokenStream& t) override;
         virtual void display(std::ostream& out) const override;
         virtual Value execute() const override;
+        virtual void gatherReferences(References& refs) const override;
+        virtual void bindIdentifiers() override;
     };
 
     class WhileStatement : public IStatement {
@@ -139,11 +179,13 @@ namespace archetype {
         virtual bool make(TokenStream& t) override;
         virtual void display(std::ostream& out) const override;
         virtual Value execute() const override;
+        virtual void gatherReferences(References& refs) const override;
+        virtual void bindIdentifiers() override;
     };
 
     class OutputStatement : public IStatement {
         Keywords::Reserved_e writeType_;
-        std::list<Expression> expressions_;
+        std::vector<Expression> expressions_;
     public:
         OutputStatement(Keywords::Reserved_e write_type = Keywords::RW_WRITE): writeType_(write_type) { }
         virtual void read(Storage& in) override;
@@ -151,18 +193,44 @@ namespace archetype {
         virtual bool make(TokenStream& t) override;
         virtual void display(std::ostream& out) const override;
         virtual Value execute() const override;
+        virtual void gatherReferences(References& refs) const override;
+        virtual void bindIdentifiers() override;
     };
 
     class ParagraphOutputStatement : public IStatement {
         std::vector<int> quoteLiterals_;
+        // The quote lines already joined into paragraphs, and the wrapped
+        // renderings of them keyed by (columns, starting cursor).
+        TextPieces text_;
+        std::string lastLine_;
+        mutable std::map<std::pair<int, int>, WrappedText> renderings_;
+        void compose_();
     public:
         virtual void read(Storage& in) override;
         virtual void write(Storage& out) const override;
         virtual bool make(TokenStream& t) override;
         virtual void display(std::ostream& out) const override;
         virtual Value execute() const override;
+        virtual void gatherReferences(References& refs) const override;
+        virtual void bindIdentifiers() override;
     };
 
+    // Statements within methods and other statements are run through here so that,
+    // when profiling, each is timed, and each counts against the turn's limits.
+    // Compound statements only group others, and statements read from a binary
+    // file have no position, so neither gets a profiling frame.
+    inline Value execute_statement(const Statement& stmt) {
+        if (TurnLimits::Enabled) {
+            TurnLimits::instance().statement();
+        }
+        if (not Profiler::Enabled or not stmt->position().known() or
+            dynamic_cast<const CompoundStatement*>(stmt.get())) {
+            return stmt->execute();
+        }
+        ProfileScope profile{stmt->position()};
+        return stmt->execute();
+    }
+
     Statement make_statement(TokenStream& t);
     Statement make_stmt_from_str(std::string src_str);
 }
@@ -9,21 +9,20 @@
 #ifndef __archetype__StringOutput__
 #define __archetype__StringOutput__
 
-#include <sstream>
 #include <string>
 
 #include "UserOutput.hh"
 
 namespace archetype {
     class StringOutput : public IUserOutput {
-        std::ostringstream stream_;
+        std::string buffer_;
     public:
         virtual ~StringOutput() { }
-        virtual void put(const std::string& line) override { stream_ << line; }
-        virtual void endLine() override { stream_ << std::endl; }
-        virtual void banner(char ch) override { for (int i = 0; i < 80; ++i) { stream_ << ch; } endLine(); }
+        virtual void put(const std::string& line) override { buffer_ += line; }
+        virtual void endLine() override { buffer_ += '\n'; }
+        virtual void banner(char ch) override { buffer_.append(80, ch); endLine(); }
 
-        std::string getOutput() const { return stream_.str(); }
+        std::string getOutput() const { return buffer_; }
     };
 
 }
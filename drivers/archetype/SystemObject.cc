@@ -14,7 +14,9 @@
 
 #include "SystemObject.hh"
 #include "Universe.hh"
+#include "collect_universe.hh"
 #include "FileStorage.hh"
+#include "Trace.hh"
 
 using namespace std;
 
@@ -30,7 +32,9 @@ namespace archetype {
         "DEBUG MESSAGES", "DEBUG EXPRESSIONS",
         "DEBUG STATEMENTS",
         "SAVE STATE", "LOAD STATE",
-        "BANNER"
+        "BANNER",
+        "DEBUG TRACE", "DUMP TRACE",
+        "SNAPSHOT", "UNDO"
     };
 
     SystemObject::SystemObject():
@@ -149,6 +153,29 @@ namespace archetype {
                             IStatement::Debug = not IStatement::Debug;
                             state_ = IDLING;
                             return Value{new BooleanValue{IStatement::Debug}};
+                        case DEBUG_TRACE:
+                            if (Trace::Enabled) {
+                                Trace::instance().disable();
+                            } else {
+                                Trace::instance().enable();
+                            }
+                            state_ = IDLING;
+                            return Value{new BooleanValue{Trace::Enabled}};
+                        case DUMP_TRACE:
+                            Universe::instance().output()->flush();
+                            Trace::instance().dump();
+                            state_ = IDLING;
+                            break;
+
+                        case SNAPSHOT:
+                            state_ = IDLING;
+                            Universe::instance().History.takeSnapshot();
+                            return Value{new BooleanValue{true}};
+                        case UNDO: {
+                            state_ = IDLING;
+                            bool undone = Universe::instance().History.undo();
+                            return Value{new BooleanValue{undone}};
+                        }
                     }
                 }
                 break;
@@ -251,6 +278,9 @@ namespace archetype {
                     string filename = filename_str->getString();
                     OutFileStorage save_file(filename);
                     if (save_file.ok()) {
+                        if (Universe::instance().collectsGarbage()) {
+                            collect_universe();
+                        }
                         save_file << Universe::instance();
                         return Value{new BooleanValue{true}};
                     } else {
@@ -307,6 +337,10 @@ namespace archetype {
         state_ = IDLING;
     }
 
+    void SystemObject::gatherReferences(References& refs) const {
+        Object::gatherReferences(refs);
+        parser_->gatherReferences(refs);
+    }
 
     void SystemObject::write(Storage& out) {
         int state_int = static_cast<int>(state_);
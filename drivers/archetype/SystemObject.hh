@@ -31,7 +31,9 @@ namespace archetype {
             DEBUG_MESSAGES, DEBUG_EXPRESSIONS,
             DEBUG_STATEMENTS,
             SAVE_STATE, LOAD_STATE,
-            BANNER
+            BANNER,
+            DEBUG_TRACE, DUMP_TRACE,
+            SNAPSHOT, UNDO
         };
 
 
@@ -41,6 +43,8 @@ namespace archetype {
 
         virtual Value executeMethod(int message_id) override;
         virtual Value executeDefaultMethod() override;
+        virtual bool hasDefaultMethod() const override { return true; }
+        virtual void gatherReferences(References& refs) const override;
 
         virtual void write(Storage& out) override;
         virtual void read(Storage& in) override;
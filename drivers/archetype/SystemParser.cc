@@ -15,6 +15,7 @@
 #include <cctype>
 
 #include "SystemParser.hh"
+#include "Expression.hh"
 
 using namespace std;
 
@@ -197,6 +198,23 @@ namespace archetype {
         }
     }
 
+    void SystemParser::gatherReferences(References& refs) const {
+        refs.objects.insert(proximate_.begin(), proximate_.end());
+        for (auto const& parseables : {&verbs_, &nouns_}) {
+            for (auto const& parseable : *parseables) {
+                refs.objects.insert(parseable.second);
+            }
+        }
+        for (auto const& matches : {&verbMatches_, &nounMatches_}) {
+            for (auto const& match : *matches) {
+                refs.objects.insert(match.second);
+            }
+        }
+        for (auto const& value : parsedValues_) {
+            refs.gather(value);
+        }
+    }
+
     template <typename T1, typename T2>
     Storage& operator<<(Storage& out, const std::pair<T1, T2>& p) {
         return out << p.first << p.second;
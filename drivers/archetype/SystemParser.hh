@@ -17,6 +17,8 @@
 #include "Value.hh"
 
 namespace archetype {
+    struct References;
+
     class SystemParser {
     public:
         enum Mode_e { VERBS, NOUNS };
@@ -59,6 +61,10 @@ namespace archetype {
         // Looks for nouns first, then verbs.  Returns undefined if no match.
         Value whichObject(std::string phrase);
 
+        // Add every object the parser knows of:  vocabulary, presence, and the
+        // values of the last parse.
+        void gatherReferences(References& refs) const;
+
         friend Storage& operator<<(Storage& out, const SystemParser& p);
         friend Storage& operator>>(Storage&in, SystemParser& p);
 
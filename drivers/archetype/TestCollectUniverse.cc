@@ -0,0 +1,157 @@
+//
+//  TestCollectUniverse.cc
+//  archetype
+//
+//
+
+#include <string>
+
+#include "TestCollectUniverse.hh"
+#include "TestRegistry.hh"
+#include "collect_universe.hh"
+#include "update_universe.hh"
+#include "Universe.hh"
+#include "SourceFile.hh"
+#include "TokenStream.hh"
+#include "StringOutput.hh"
+
+using namespace std;
+
+namespace archetype {
+    ARCHETYPE_TEST_REGISTER(TestCollectUniverse);
+
+    static char program_items[] =
+    "type item_type based on null\n"
+    "  inside: UNDEFINED\n"
+    "  name: \"coin\"\n"
+    "methods\n"
+    "  'BUILD': name -> system\n"
+    "end\n"
+    "\n"
+    "item_type lamp end\n"
+    "\n"
+    "null main\n"
+    "  kept: UNDEFINED\n"
+    "  extra: UNDEFINED\n"
+    "methods\n"
+    "  'START': {\n"
+    "    create item_type named kept\n"
+    "    create item_type named extra\n"
+    "    kept.inside := extra\n"
+    "    create item_type named extra\n"
+    "    extra.inside := extra\n"
+    "    create item_type named extra\n"
+    "  }\n"
+    "  'UPDATE': {\n"
+    "    create item_type named extra\n"
+    "    write \"Made one.\"\n"
+    "  }\n"
+    "end\n"
+    ;
+
+    static int live_objects() {
+        Universe& u = Universe::instance();
+        int live = 0;
+        for (int id = Universe::UserObjectsBeginAt; id < u.objectCount(); ++id) {
+            if (u.getObject(id)) {
+                live++;
+            }
+        }
+        return live;
+    }
+
+    static bool start(const char* program) {
+        Universe::destroy();
+        TokenStream t(make_source_from_str("items", program));
+        Universe::instance().setOutput(UserOutput{new StringOutput});
+        return Universe::instance().make(t);
+    }
+
+    void TestCollectUniverse::testUnreachable_() {
+        ARCHETYPE_TEST(start(program_items));
+        Universe& u = Universe::instance();
+        // item_type, lamp and main
+        ARCHETYPE_TEST_EQUAL(live_objects(), 3);
+        ARCHETYPE_TEST_EQUAL(collect_universe(), 0);
+
+        dispatch_to_universe("START");
+        ARCHETYPE_TEST_EQUAL(live_objects(), 7);
+        Value inside = make_stmt_from_str("main.kept.inside")->execute()->objectConversion();
+        int inside_id = inside->getObject();
+        // Only the instance that refers to nothing but itself is gone
+        ARCHETYPE_TEST_EQUAL(collect_universe(), 1);
+        ARCHETYPE_TEST_EQUAL(live_objects(), 6);
+        ARCHETYPE_TEST(u.getObject(inside_id) != nullptr);
+        ARCHETYPE_TEST(make_stmt_from_str("main.extra")->execute()->isDefined());
+        ARCHETYPE_TEST(u.getObject("lamp") != nullptr);
+        ARCHETYPE_TEST_EQUAL(collect_universe(), 0);
+
+        // Forgetting the last reference lets everything hanging from it go
+        make_stmt_from_str("main.kept := UNDEFINED")->execute();
+        ARCHETYPE_TEST_EQUAL(collect_universe(), 2);
+        ARCHETYPE_TEST(u.getObject(inside_id) == nullptr);
+        Universe::destroy();
+    }
+
+    void TestCollectUniverse::testRoots_() {
+        ARCHETYPE_TEST(start(program_items));
+        Universe& u = Universe::instance();
+
+        // Known only to the parser
+        make_stmt_from_str("{'OPEN PARSER' -> system; create item_type named main.extra; "
+                           "'BUILD' -> main.extra; 'CLOSE PARSER' -> system}")->execute();
+        int parsed_id = make_stmt_from_str("main.extra")->execute()->objectConversion()->getObject();
+        // Known only to a context being run
+        ObjectPtr running = u.defineNewObject(u.getObject("item_type")->id());
+        make_stmt_from_str("main.extra := UNDEFINED")->execute();
+        Universe::Context context = u.currentContext();
+        context.selfObject = running;
+        u.pushContext(context);
+        ARCHETYPE_TEST_EQUAL(collect_universe(), 0);
+        u.popContext();
+        ARCHETYPE_TEST(u.getObject(parsed_id) != nullptr);
+        make_stmt_from_str("{'PLAYER CMD' -> system; \"coin\" -> system; 'PARSE' -> system}")->execute();
+        Value parsed = make_stmt_from_str("'NEXT OBJECT' -> system")->execute();
+        ARCHETYPE_TEST_EQUAL(parsed->getObject(), parsed_id);
+
+        // Once nothing runs it, it can go
+        ARCHETYPE_TEST_EQUAL(collect_universe(), 1);
+        ARCHETYPE_TEST(u.getObject(parsed_id) != nullptr);
+        Universe::destroy();
+    }
+
+    static string play(MemoryStorage& game) {
+        MemoryStorage out;
+        string output = update_universe(game, out, "");
+        game = MemoryStorage();
+        game.bytes() = out.bytes();
+        return output;
+    }
+
+    void TestCollectUniverse::testBetweenTurns_() {
+        ARCHETYPE_TEST(start(program_items));
+        MemoryStorage game;
+        game << Universe::instance();
+
+        // Every turn leaves another instance behind
+        play(game);
+        play(game);
+        ARCHETYPE_TEST_EQUAL(live_objects(), 5);
+
+        Universe::instance().setCollectsGarbage(true);
+        ARCHETYPE_TEST_EQUAL(play(game), string("Made one.\n"));
+        size_t saved = game.bytes().size();
+        ARCHETYPE_TEST_EQUAL(live_objects(), 4);
+        play(game);
+        play(game);
+        ARCHETYPE_TEST_EQUAL(live_objects(), 4);
+        ARCHETYPE_TEST_EQUAL(game.bytes().size(), saved);
+        Universe::destroy();
+    }
+
+    void TestCollectUniverse::runTests_() {
+        testUnreachable_();
+        testRoots_();
+        testBetweenTurns_();
+    }
+}
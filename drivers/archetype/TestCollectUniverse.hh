@@ -0,0 +1,27 @@
+//
+//  TestCollectUniverse.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__TestCollectUniverse__
+#define __archetype__TestCollectUniverse__
+
+#include <iostream>
+#include <string>
+
+#include "ITestSuite.hh"
+
+namespace archetype {
+    class TestCollectUniverse : public ITestSuite {
+        void testUnreachable_();
+        void testRoots_();
+        void testBetweenTurns_();
+    protected:
+        virtual void runTests_() override;
+    public:
+        TestCollectUniverse(std::string name): ITestSuite(name) { }
+    };
+}
+
+#endif /* defined(__archetype__TestCollectUniverse__) */
@@ -0,0 +1,139 @@
+//
+//  TestComputedAttributes.cc
+//  archetype
+//
+//
+
+#include <string>
+
+#include "TestComputedAttributes.hh"
+#include "TestRegistry.hh"
+#include "ComputedAttributes.hh"
+#include "Expression.hh"
+#include "Universe.hh"
+#include "SourceFile.hh"
+#include "TokenStream.hh"
+#include "StringOutput.hh"
+#include "update_universe.hh"
+
+using namespace std;
+
+namespace archetype {
+    ARCHETYPE_TEST_REGISTER(TestComputedAttributes);
+
+    static char program_items[] =
+    "type item based on null\n"
+    "  weight: 1\n"
+    "  desc: \"thing\"\n"
+    "  heavy: weight > 5\n"
+    "  label: \"a \" & desc\n"
+    "  rolled: ?6\n"
+    "  asked: 'weigh' -> self\n"
+    "  wobbly: asked > 5\n"
+    "methods\n"
+    "  'weigh': weight\n"
+    "end\n"
+    "item rock weight: 10 desc: \"rock\" end\n"
+    "item feather end\n"
+    ;
+
+    static void make_items() {
+        Universe::destroy();
+        TokenStream t(make_source_from_str("items", program_items));
+        Universe::instance().make(t);
+    }
+
+    static string eval(string src) {
+        return make_expr_from_str(src)->evaluate()->stringConversion()->getString();
+    }
+
+    void TestComputedAttributes::testKeeping_() {
+        make_items();
+        ComputedAttributes& computed = ComputedAttributes::instance();
+        ARCHETYPE_TEST_EQUAL(eval("rock.heavy"), string{"TRUE"});
+        ARCHETYPE_TEST_EQUAL(eval("feather.heavy"), string{"FALSE"});
+        long long hits = computed.hits();
+        ARCHETYPE_TEST_EQUAL(eval("rock.heavy"), string{"TRUE"});
+        ARCHETYPE_TEST_EQUAL(eval("feather.heavy"), string{"FALSE"});
+        ARCHETYPE_TEST_EQUAL(computed.hits(), hits + 2);
+
+        // Turned off, nothing kept is used, and the answers are the same
+        ComputedAttributes::Enabled = false;
+        ARCHETYPE_TEST_EQUAL(eval("rock.heavy"), string{"TRUE"});
+        ARCHETYPE_TEST_EQUAL(computed.hits(), hits + 2);
+        ComputedAttributes::Enabled = true;
+    }
+
+    void TestComputedAttributes::testInvalidation_() {
+        make_items();
+        ARCHETYPE_TEST_EQUAL(eval("rock.heavy"), string{"TRUE"});
+        ARCHETYPE_TEST_EQUAL(eval("feather.label"), string{"a thing"});
+
+        // Written on the object itself, and on the type it inherits from
+        make_expr_from_str("rock.weight := 2")->evaluate();
+        ARCHETYPE_TEST_EQUAL(eval("rock.heavy"), string{"FALSE"});
+        ARCHETYPE_TEST_EQUAL(eval("feather.heavy"), string{"FALSE"});
+        make_expr_from_str("item.weight := 100")->evaluate();
+        ARCHETYPE_TEST_EQUAL(eval("feather.heavy"), string{"TRUE"});
+        ARCHETYPE_TEST_EQUAL(eval("rock.heavy"), string{"FALSE"});
+
+        // Appended to in place
+        make_expr_from_str("feather.desc := \"feather\"")->evaluate();
+        ARCHETYPE_TEST_EQUAL(eval("feather.label"), string{"a feather"});
+        make_expr_from_str("feather.desc &:= \"s\"")->evaluate();
+        ARCHETYPE_TEST_EQUAL(eval("feather.label"), string{"a feathers"});
+
+        // The expression itself replaced
+        make_expr_from_str("rock.heavy := \"very\"")->evaluate();
+        ARCHETYPE_TEST_EQUAL(eval("rock.heavy"), string{"very"});
+    }
+
+    void TestComputedAttributes::testImpure_() {
+        make_items();
+        ComputedAttributes& computed = ComputedAttributes::instance();
+        long long hits = computed.hits();
+        ARCHETYPE_TEST_EQUAL(eval("rock.asked"), string{"10"});
+        ARCHETYPE_TEST_EQUAL(eval("rock.asked"), string{"10"});
+        eval("rock.rolled");
+        eval("rock.rolled");
+        // Pure itself, but reading an attribute that sends a message
+        ARCHETYPE_TEST_EQUAL(eval("rock.wobbly"), string{"TRUE"});
+        ARCHETYPE_TEST_EQUAL(eval("rock.wobbly"), string{"TRUE"});
+        ARCHETYPE_TEST_EQUAL(computed.hits(), hits);
+    }
+
+    static char program_unset[] =
+    "null other end\n"
+    "null item heavy: other.weight + 1 end\n"
+    "null main\n"
+    "methods\n"
+    "  'START': { write item.heavy; other.weight := 5; write item.heavy }\n"
+    "end\n"
+    ;
+
+    void TestComputedAttributes::testUnsetReads_() {
+        Universe::destroy();
+        TokenStream t(make_source_from_str("unset", program_unset));
+        ARCHETYPE_TEST(Universe::instance().make(t));
+        // Marking the attribute unset, on the first read, does not count as writing it
+        long long hits = ComputedAttributes::instance().hits();
+        Expression heavy = make_expr_from_str("item.heavy");
+        ARCHETYPE_TEST(not heavy->evaluate()->valueConversion()->isDefined());
+        ARCHETYPE_TEST(not heavy->evaluate()->valueConversion()->isDefined());
+        ARCHETYPE_TEST_EQUAL(ComputedAttributes::instance().hits(), hits + 1);
+
+        StringOutput* output = new StringOutput;
+        Universe::instance().setOutput(UserOutput{output});
+        // Reading an attribute nothing holds yet is still a read of it
+        dispatch_to_universe("START");
+        ARCHETYPE_TEST_EQUAL(output->getOutput(), string{"\n6\n"});
+        Universe::destroy();
+    }
+
+    void TestComputedAttributes::runTests_() {
+        testKeeping_();
+        testInvalidation_();
+        testImpure_();
+        testUnsetReads_();
+    }
+}
@@ -0,0 +1,28 @@
+//
+//  TestComputedAttributes.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__TestComputedAttributes__
+#define __archetype__TestComputedAttributes__
+
+#include <iostream>
+#include <string>
+
+#include "ITestSuite.hh"
+
+namespace archetype {
+    class TestComputedAttributes : public ITestSuite {
+        void testKeeping_();
+        void testInvalidation_();
+        void testImpure_();
+        void testUnsetReads_();
+    protected:
+        virtual void runTests_() override;
+    public:
+        TestComputedAttributes(std::string name): ITestSuite(name) { }
+    };
+}
+
+#endif /* defined(__archetype__TestComputedAttributes__) */
@@ -204,6 +204,22 @@ namespace archetype {
             {"13 - - 14", new NumericValue{27}},
             {"2^4", new NumericValue{16}},
             {"3 ^ \"4\"", new NumericValue{81}},
+            {"2 ^ 30", new NumericValue{1073741824}},
+            {"(0 - 3) ^ 3", new NumericValue{-27}},
+            {"2 ^ (0 - 1)", new NumericValue{0}},
+            {"(0 - 1) ^ (0 - 3)", new NumericValue{-1}},
+
+            // Comparisons of like kinds, which skip the conversions
+            {"12 >= 12", new BooleanValue{true}},
+            {"'look' = 'look'", new BooleanValue{true}},
+            {"'look' ~= 'take'", new BooleanValue{true}},
+            {"'look' < 'take'", new BooleanValue{true}},
+            {"'take' <= 'look'", new BooleanValue{false}},
+            {"'look' >= 'look'", new BooleanValue{true}},
+            {"\"abc\" <= \"abc\"", new BooleanValue{true}},
+            {"\"abc\" < \"abc\"", new BooleanValue{false}},
+            {"scratch >= scratch", new BooleanValue{false}},
+            {"scratch ~= system", new BooleanValue{true}},
 
             // Testing these cumulative operators requires executing these statements
             // in order.  Be careful of rearranging the tests.
@@ -327,11 +343,36 @@ namespace archetype {
         ARCHETYPE_TEST(expr7 != nullptr);
     }
 
+    void TestExpression::testAccumulation_() {
+        Universe::destroy();
+        TokenStream tokens(make_source_from_str("accumulation", "null box s : \"\" t : UNDEFINED end"));
+        ARCHETYPE_TEST(Universe::instance().make(tokens));
+        Expression append = make_expr_from_str("box.s &:= \"ab\"");
+        for (int i = 0; i < 1000; ++i) {
+            append->evaluate();
+        }
+        Value s = make_expr_from_str("box.s")->evaluate()->valueConversion();
+        ARCHETYPE_TEST_EQUAL(s->getString().size(), size_t(2000));
+
+        // Whoever else holds the string keeps it as it was
+        make_expr_from_str("box.t := box.s")->evaluate();
+        append->evaluate();
+        Value t = make_expr_from_str("box.t")->evaluate()->valueConversion();
+        ARCHETYPE_TEST_EQUAL(t->getString().size(), size_t(2000));
+        ARCHETYPE_TEST(s->isSameValueAs(t));
+        ARCHETYPE_TEST_EQUAL(make_expr_from_str("box.s")->evaluate()->valueConversion()->getString().size(),
+                             size_t(2002));
+        s = make_expr_from_str("box.s")->evaluate()->valueConversion();
+        append->evaluate();
+        ARCHETYPE_TEST_EQUAL(s->getString().size(), size_t(2002));
+    }
+
     void TestExpression::runTests_() {
         testTranslation_();
         testEvaluation_();
         testSerialization_();
         testInput_();
         testVerification_();
+        testAccumulation_();
     }
 }
@@ -20,6 +20,7 @@ namespace archetype {
         void testSerialization_();
         void testInput_();
         void testVerification_();
+        void testAccumulation_();
     protected:
         virtual void runTests_() override;
     public:
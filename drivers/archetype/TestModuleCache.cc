@@ -0,0 +1,113 @@
+//
+//  TestModuleCache.cc
+//  archetype
+//
+//
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#include "TestModuleCache.hh"
+#include "TestRegistry.hh"
+#include "ModuleCache.hh"
+#include "Universe.hh"
+#include "Wellspring.hh"
+#include "Capture.hh"
+
+using namespace std;
+
+namespace archetype {
+    ARCHETYPE_TEST_REGISTER(TestModuleCache);
+
+    static char program_pantry[] =
+    "include \"cache_snacks\"\n"
+    "null pantry\n"
+    "methods\n"
+    "  'open' : 'eat' -> cracker\n"
+    "end\n"
+    ;
+
+    static char program_snacks[] =
+    "include \"cache_edible\"\n"
+    "edible cracker desc : \"cracker\" end\n"
+    ;
+
+    static char program_edible[] =
+    "type edible based on null\n"
+    "  desc: \"snack\"\n"
+    "methods\n"
+    "  'eat': write \"You gobble down the \", desc, \".\"\n"
+    "end\n"
+    ;
+
+    static void write_file(string path, string contents) {
+        ofstream out(path.c_str());
+        out << contents;
+    }
+
+    // Compiles program_pantry from scratch and returns the resulting Universe, serialized.
+    static string compile_pantry(string directory) {
+        Universe::destroy();
+        Wellspring::destroy();
+        Wellspring::instance().addSearchPath(directory);
+        TokenStream t(make_source_from_str("pantry", program_pantry));
+        if (not Universe::instance().make(t)) {
+            return "";
+        }
+        MemoryStorage mem;
+        mem << Universe::instance();
+        return string(mem.bytes().begin(), mem.bytes().end());
+    }
+
+    void TestModuleCache::testLinking_() {
+        const char* tmp = getenv("TMPDIR");
+        string directory = string(tmp ? tmp : "/tmp") + "/archetype_cache_" + to_string(getpid());
+        string cache_directory = directory + "/cache";
+        ModuleCache::destroy();
+        mkdir(directory.c_str(), 0755);
+        ModuleCache::instance().setDirectory(cache_directory);
+        write_file(directory + "/cache_snacks.ach", program_snacks);
+        write_file(directory + "/cache_edible.ach", program_edible);
+
+        // The first compilation misses on both includes and stores them.
+        string compiled = compile_pantry(directory);
+        ARCHETYPE_TEST(not compiled.empty());
+        ARCHETYPE_TEST_EQUAL(ModuleCache::instance().hits(), 0);
+        ARCHETYPE_TEST_EQUAL(ModuleCache::instance().misses(), 2);
+
+        // The second links the outermost include and ends up in an identical Universe.
+        string linked = compile_pantry(directory);
+        ARCHETYPE_TEST_EQUAL(ModuleCache::instance().hits(), 1);
+        ARCHETYPE_TEST_EQUAL(ModuleCache::instance().misses(), 2);
+        ARCHETYPE_TEST(linked == compiled);
+        Capture capture;
+        Statement stmt = make_stmt_from_str("'open' -> pantry");
+        stmt->execute();
+        ARCHETYPE_TEST_EQUAL(capture.getCapture(), string("You gobble down the cracker.\n"));
+
+        // Changing a nested include invalidates both fragments.
+        write_file(directory + "/cache_edible.ach", string(program_edible) + "edible granola end\n");
+        string recompiled = compile_pantry(directory);
+        ARCHETYPE_TEST(not recompiled.empty());
+        ARCHETYPE_TEST(recompiled != compiled);
+        ARCHETYPE_TEST_EQUAL(ModuleCache::instance().hits(), 1);
+        ARCHETYPE_TEST_EQUAL(ModuleCache::instance().misses(), 4);
+        string relinked = compile_pantry(directory);
+        ARCHETYPE_TEST_EQUAL(ModuleCache::instance().hits(), 2);
+        ARCHETYPE_TEST(relinked == recompiled);
+
+        ModuleCache::destroy();
+        Wellspring::destroy();
+        Universe::destroy();
+        string remove_all = "rm -rf " + directory;
+        ARCHETYPE_TEST_EQUAL(system(remove_all.c_str()), 0);
+    }
+
+    void TestModuleCache::runTests_() {
+        testLinking_();
+    }
+}
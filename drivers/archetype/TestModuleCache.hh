@@ -0,0 +1,22 @@
+//
+//  TestModuleCache.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__TestModuleCache__
+#define __archetype__TestModuleCache__
+
+#include "ITestSuite.hh"
+
+namespace archetype {
+    class TestModuleCache : public ITestSuite {
+        void testLinking_();
+    protected:
+        virtual void runTests_() override;
+    public:
+        TestModuleCache(std::string name): ITestSuite(name) { }
+    };
+}
+
+#endif /* defined(__archetype__TestModuleCache__) */
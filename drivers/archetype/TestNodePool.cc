@@ -0,0 +1,71 @@
+//
+//  TestNodePool.cc
+//  archetype
+//
+//
+
+#include <string>
+
+#include "TestNodePool.hh"
+#include "TestRegistry.hh"
+#include "NodePool.hh"
+#include "Statement.hh"
+#include "Universe.hh"
+#include "SourceFile.hh"
+#include "TokenStream.hh"
+
+using namespace std;
+
+namespace archetype {
+    ARCHETYPE_TEST_REGISTER(TestNodePool);
+
+    static char program_pooled[] =
+    "null lamp\n"
+    "  lit: FALSE\n"
+    "methods\n"
+    "  'light': { lit := TRUE; write \"The lamp is now lit.\" }\n"
+    "  'examine': if lit then \"It glows.\" else \"It is dark.\"\n"
+    "end\n"
+    ;
+
+    void TestNodePool::testReuse_() {
+        NodePool& pool = NodePool::instance();
+        long long before = pool.live();
+        const IExpression* first_node;
+        {
+            Expression first = make_expr_from_str("12 + 5");
+            ARCHETYPE_TEST(first != nullptr);
+            ARCHETYPE_TEST(pool.live() > before);
+            first_node = first.get();
+            // Keep one node alive, so that the chunks are not given back
+            Expression keep = make_expr_from_str("7");
+            first.reset();
+            // A node of the same size takes the slot just given up
+            Expression second = make_expr_from_str("12 + 5");
+            ARCHETYPE_TEST(second.get() == first_node);
+        }
+        ARCHETYPE_TEST_EQUAL(pool.live(), before);
+    }
+
+    void TestNodePool::testRelease_() {
+        Universe::destroy();
+        NodePool& pool = NodePool::instance();
+        ARCHETYPE_TEST_EQUAL(pool.live(), 0LL);
+        ARCHETYPE_TEST_EQUAL(pool.chunks(), size_t(0));
+        {
+            TokenStream t(make_source_from_str("pooled", program_pooled));
+            ARCHETYPE_TEST(Universe::instance().make(t));
+            ARCHETYPE_TEST(pool.live() > 0);
+            ARCHETYPE_TEST(pool.chunks() > 0);
+        }
+        // Everything compiled goes with the Universe, and the chunks with it
+        Universe::destroy();
+        ARCHETYPE_TEST_EQUAL(pool.live(), 0LL);
+        ARCHETYPE_TEST_EQUAL(pool.chunks(), size_t(0));
+    }
+
+    void TestNodePool::runTests_() {
+        testReuse_();
+        testRelease_();
+    }
+}
@@ -0,0 +1,26 @@
+//
+//  TestNodePool.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__TestNodePool__
+#define __archetype__TestNodePool__
+
+#include <iostream>
+#include <string>
+
+#include "ITestSuite.hh"
+
+namespace archetype {
+    class TestNodePool : public ITestSuite {
+        void testReuse_();
+        void testRelease_();
+    protected:
+        virtual void runTests_() override;
+    public:
+        TestNodePool(std::string name): ITestSuite(name) { }
+    };
+}
+
+#endif /* defined(__archetype__TestNodePool__) */
@@ -17,6 +17,7 @@
 #include "TokenStream.hh"
 #include "Expression.hh"
 #include "Capture.hh"
+#include "SourceFile.hh"
 
 using namespace std;
 
@@ -103,6 +104,57 @@ namespace archetype {
         string expected3 = "an unremarkable dank cellar of a room";
         string actual3 = val_b_2->getString();
         ARCHETYPE_TEST_EQUAL(actual3, expected3);
+
+        // A parent once found is kept, but not past its destruction
+        ARCHETYPE_TEST(courtyard->findAttribute(desc_id) != nullptr);
+        ARCHETYPE_TEST(courtyard->parent() == room_type);
+        Universe::instance().destroyObject(room_type->id());
+        ARCHETYPE_TEST(courtyard->parent() == nullptr);
+        ARCHETYPE_TEST(courtyard->findAttribute(desc_id) == nullptr);
+        ARCHETYPE_TEST(basement->findAttribute(desc_id) != nullptr);
+        ARCHETYPE_TEST(basement->findAttribute(full_id) == nullptr);
+    }
+
+    void TestObject::testUnsetAttributes_() {
+        ObjectPtr gem_type = Universe::instance().defineNewObject();
+        gem_type->setPrototype(true);
+        Universe::instance().assignObjectIdentifier(gem_type, "gem");
+        ObjectPtr ruby = Universe::instance().defineNewObject(gem_type->id());
+        Universe::instance().assignObjectIdentifier(ruby, "ruby");
+        ObjectPtr opal = Universe::instance().defineNewObject(gem_type->id());
+        Universe::instance().assignObjectIdentifier(opal, "opal");
+        int shine_id = Universe::instance().Identifiers.index("shine");
+
+        // Reading an attribute nothing holds gives UNDEFINED, and the object has it
+        // from then on, without anything being assigned
+        MemoryStorage before;
+        ruby->write(before);
+        ARCHETYPE_TEST(not make_expr_from_str("ruby.shine")->evaluate()->valueConversion()->isDefined());
+        ARCHETYPE_TEST(ruby->hasAttribute(shine_id));
+        ARCHETYPE_TEST(ruby->findAttribute(shine_id) == nullptr);
+        ARCHETYPE_TEST(not opal->hasAttribute(shine_id));
+        MemoryStorage after;
+        ruby->write(after);
+        ARCHETYPE_TEST(after.bytes().size() - before.bytes().size() < 8);
+
+        // So it stays UNDEFINED when the type is given it, unlike an object never asked
+        make_expr_from_str("gem.shine := 3")->evaluate();
+        ARCHETYPE_TEST(not make_expr_from_str("ruby.shine")->evaluate()->valueConversion()->isDefined());
+        ARCHETYPE_TEST_EQUAL(make_expr_from_str("opal.shine")->evaluate()->numericConversion()->getNumber(), 3);
+
+        // Until it is assigned, and it survives being saved
+        make_expr_from_str("ruby.shine := 5")->evaluate();
+        ARCHETYPE_TEST_EQUAL(make_expr_from_str("ruby.shine")->evaluate()->numericConversion()->getNumber(), 5);
+        ObjectPtr jade = Universe::instance().defineNewObject(gem_type->id());
+        Universe::instance().assignObjectIdentifier(jade, "jade");
+        make_expr_from_str("jade.lustre")->evaluate()->valueConversion();
+        MemoryStorage saved;
+        jade->write(saved);
+        ObjectPtr copy = make_shared<Object>();
+        copy->read(saved);
+        int lustre_id = Universe::instance().Identifiers.index("lustre");
+        ARCHETYPE_TEST(copy->hasAttribute(lustre_id));
+        ARCHETYPE_TEST(copy->findAttribute(shine_id) != nullptr);
     }
 
     void TestObject::testMethods_() {
@@ -166,10 +218,58 @@ namespace archetype {
         ARCHETYPE_TEST_EQUAL(actual2, expected2);
     }
 
+    static char program_tail_sends[] =
+    "null counter\n"
+    "  n: 0\n"
+    "methods\n"
+    "  'count': if n < 20000 then { n +:= 1; 'count' -> self } else n\n"
+    "  'relay': 'unheard' -> listener\n"
+    "  'forward': 'unheard' -> polite\n"
+    "end\n"
+    "null listener end\n"
+    "null polite\n"
+    "methods\n"
+    "  default: { write \"polite heard \", message; \"fallback\" }\n"
+    "end\n"
+    "null grumpy\n"
+    "methods\n"
+    "  'complain': 'unheard' -> listener\n"
+    "  default: write \"grumpy heard \", message\n"
+    "end\n"
+    ;
+
+    void TestObject::testTailSends_() {
+        Universe::destroy();
+        TokenStream t(make_source_from_str("tail_sends", program_tail_sends));
+        ARCHETYPE_TEST(Universe::instance().make(t));
+
+        // Far deeper than the native stack would allow, were each send a new frame.
+        Value count = make_stmt_from_str("'count' -> counter")->execute();
+        ARCHETYPE_TEST_EQUAL(count->numericConversion()->getNumber(), 20000);
+
+        // A tail send that finds no method leaves the method's value ABSENT.
+        Value relayed = make_stmt_from_str("'relay' -> counter")->execute();
+        ARCHETYPE_TEST(relayed->isSameValueAs(Value{new AbsentValue}));
+
+        // The recipient of a tail send still gets to run its default method.
+        Capture forwarded;
+        Value forward = make_stmt_from_str("'forward' -> counter")->execute();
+        ARCHETYPE_TEST_EQUAL(forwarded.getCapture(), string("polite heard unheard\n"));
+        ARCHETYPE_TEST_EQUAL(forward->stringConversion()->getString(), string("fallback"));
+
+        // And so does an object whose own tail send went unanswered.
+        Capture complained;
+        make_stmt_from_str("'complain' -> grumpy")->execute();
+        ARCHETYPE_TEST_EQUAL(complained.getCapture(), string("grumpy heard complain\n"));
+        Universe::destroy();
+    }
+
     void TestObject::runTests_() {
         testObjects_();
         testInheritance_();
+        testUnsetAttributes_();
         testMethods_();
         testMessagePassing_();
+        testTailSends_();
     }
 }
@@ -17,8 +17,10 @@ namespace archetype {
     class TestObject : public ITestSuite {
         void testObjects_();
         void testInheritance_();
+        void testUnsetAttributes_();
         void testMethods_();
         void testMessagePassing_();
+        void testTailSends_();
     protected:
         virtual void runTests_() override;
     public:
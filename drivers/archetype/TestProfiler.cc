@@ -0,0 +1,124 @@
+//
+//  TestProfiler.cc
+//  archetype
+//
+//
+
+#include <string>
+#include <sstream>
+#include <map>
+
+#include "TestProfiler.hh"
+#include "TestRegistry.hh"
+#include "Profiler.hh"
+#include "Statement.hh"
+#include "Universe.hh"
+#include "SourceFile.hh"
+#include "TokenStream.hh"
+#include "Capture.hh"
+
+using namespace std;
+
+namespace archetype {
+    ARCHETYPE_TEST_REGISTER(TestProfiler);
+
+    static char program_counter[] =
+    "null counter\n"
+    "  n: 0\n"
+    "methods\n"
+    "  'run': {\n"
+    "    n := 0\n"
+    "    while n < 5 do\n"
+    "      'bump' -> self\n"
+    "  }\n"
+    "  'bump': n +:= 1\n"
+    "end\n"
+    ;
+
+    void TestProfiler::testPositions_() {
+        Universe::destroy();
+        TokenStream t(make_source_from_str("positions",
+                                           "{\n"
+                                           "  n := 0\n"
+                                           "  while n < 5 do\n"
+                                           "    n +:= 1\n"
+                                           "}\n"));
+        Statement stmt = make_statement(t);
+        ARCHETYPE_TEST(stmt != nullptr);
+        if (not stmt) {
+            return;
+        }
+        ARCHETYPE_TEST_EQUAL(stmt->position().filename(), string("positions"));
+        ARCHETYPE_TEST_EQUAL(stmt->position().line(), 1);
+        CompoundStatement* body = dynamic_cast<CompoundStatement*>(stmt.get());
+        ARCHETYPE_TEST(body != nullptr);
+        if (body) {
+            ARCHETYPE_TEST_EQUAL(body->statements().front()->position().line(), 2);
+            ARCHETYPE_TEST_EQUAL(body->statements().back()->position().line(), 3);
+            ExpressionStatement* assignment =
+                dynamic_cast<ExpressionStatement*>(body->statements().front().get());
+            ARCHETYPE_TEST(assignment != nullptr);
+            if (assignment) {
+                ARCHETYPE_TEST_EQUAL(assignment->expression()->position().line(), 2);
+            }
+        }
+
+        // Positions are not serialized.
+        MemoryStorage mem;
+        mem << stmt;
+        Statement stmt_back;
+        mem >> stmt_back;
+        ARCHETYPE_TEST(not stmt_back->position().known());
+    }
+
+    void TestProfiler::testFoldedStacks_() {
+        Universe::destroy();
+        Profiler::destroy();
+        TokenStream t(make_source_from_str("counter", program_counter));
+        ARCHETYPE_TEST(Universe::instance().make(t));
+        Statement stmt = make_stmt_from_str("'run' -> counter");
+
+        Profiler::instance().start("");
+        stmt->execute();
+        Profiler::Enabled = false;
+
+        // One line per call path, ending in the nanoseconds spent in its last frame.
+        ostringstream folded;
+        Profiler::instance().writeFoldedStacks(folded);
+        map<string, long long> stacks;
+        istringstream lines(folded.str());
+        string line;
+        while (getline(lines, line)) {
+            auto space = line.rfind(' ');
+            stacks[line.substr(0, space)] = stoll(line.substr(space + 1));
+        }
+        ARCHETYPE_TEST(stacks.count("'run' -> counter"));
+        ARCHETYPE_TEST(stacks.count("'run' -> counter;counter:5"));
+        ARCHETYPE_TEST(stacks.count("'run' -> counter;counter:6"));
+        ARCHETYPE_TEST(stacks.count("'run' -> counter;counter:6;counter:7;'bump' -> counter"));
+        ARCHETYPE_TEST(stacks.count("'run' -> counter;counter:6;counter:7;'bump' -> counter;counter:9"));
+
+        ostringstream summary;
+        Profiler::instance().writeSummary(summary, 10);
+        ARCHETYPE_TEST(summary.str().find("'bump' -> counter") != string::npos);
+        // The dispatch of 'bump' is counted once for each time around the loop.
+        istringstream summary_lines(summary.str());
+        bool found_bump = false;
+        while (getline(summary_lines, line)) {
+            if (line.find("'bump' -> counter") != string::npos) {
+                istringstream fields(line);
+                long long calls;
+                fields >> calls;
+                ARCHETYPE_TEST_EQUAL(calls, 5LL);
+                found_bump = true;
+            }
+        }
+        ARCHETYPE_TEST(found_bump);
+        Profiler::destroy();
+    }
+
+    void TestProfiler::runTests_() {
+        testPositions_();
+        testFoldedStacks_();
+    }
+}
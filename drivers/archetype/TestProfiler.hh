@@ -0,0 +1,26 @@
+//
+//  TestProfiler.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__TestProfiler__
+#define __archetype__TestProfiler__
+
+#include <iostream>
+#include <string>
+
+#include "ITestSuite.hh"
+
+namespace archetype {
+    class TestProfiler : public ITestSuite {
+        void testPositions_();
+        void testFoldedStacks_();
+    protected:
+        virtual void runTests_() override;
+    public:
+        TestProfiler(std::string name): ITestSuite(name) { }
+    };
+}
+
+#endif /* defined(__archetype__TestProfiler__) */
@@ -16,6 +16,8 @@
 #include "Statement.hh"
 #include "Universe.hh"
 #include "Capture.hh"
+#include "StringOutput.hh"
+#include "WrappedOutput.hh"
 
 using namespace std;
 
@@ -126,6 +128,53 @@ namespace archetype {
         ARCHETYPE_TEST_EQUAL(actual9, string("Here's a poem:\n Roses are red\n Violets are blue\n\nThe end.\n"));
     }
 
+    // The same text put one line at a time, the way a paragraph was written before it was
+    // joined at compile time.
+    static string put_paragraph_lines(int columns, string lead) {
+        UserOutput strout{new StringOutput};
+        WrappedOutput wrapped{strout, columns};
+        wrapped.put(lead);
+        wrapped.put("The lamp is lit.");
+        wrapped.put("  ");
+        wrapped.put("It casts a warm glow over the room,");
+        wrapped.put(" ");
+        wrapped.put("reaching even the corners");
+        wrapped.endLine();
+        wrapped.put(" and the table.");
+        wrapped.endLine();
+        wrapped.put("Done");
+        wrapped.endLine();
+        return dynamic_cast<StringOutput*>(strout.get())->getOutput();
+    }
+
+    void TestStatement::testParagraphWrapping_() {
+        Universe::destroy();
+        Statement stmt = make_stmt_from_str(">>The lamp is lit.\n>>It casts a warm glow over the room,\n"
+                                            ">>reaching even the corners\n>> and the table.\n>>Done");
+        ARCHETYPE_TEST(stmt != nullptr);
+        if (not stmt) {
+            return;
+        }
+        UserOutput previous = Universe::instance().output();
+        for (int columns : {0, 12, 20, 31}) {
+            for (string lead : {"", "Look: ", "You are in the parlor."}) {
+                UserOutput strout{new StringOutput};
+                UserOutput wrapped{new WrappedOutput{strout, columns}};
+                Universe::instance().setOutput(wrapped);
+                // Twice, so that the second comes from the cached rendering.
+                for (int i = 0; i < 2; ++i) {
+                    wrapped->put(lead);
+                    Value val = stmt->execute();
+                    ARCHETYPE_TEST_EQUAL(val->getString(), string("Done"));
+                }
+                string expected = put_paragraph_lines(columns, lead);
+                ARCHETYPE_TEST_EQUAL(dynamic_cast<StringOutput*>(strout.get())->getOutput(),
+                                     expected + expected);
+            }
+        }
+        Universe::instance().setOutput(previous);
+    }
+
     void TestStatement::testLoopBreaks_() {
         Universe::destroy();
         ObjectPtr x = Universe::instance().defineNewObject();
@@ -202,6 +251,7 @@ namespace archetype {
     void TestStatement::runTests_() {
         testConstruction_();
         testExecution_();
+        testParagraphWrapping_();
         testLoopBreaks_();
         testForEach_();
         testSerialization_();
@@ -10,6 +10,7 @@
 #define __archetype__TestStatement__
 
 #include <iostream>
+#include <string>
 
 #include "ITestSuite.hh"
 
@@ -17,6 +18,7 @@ namespace archetype {
     class TestStatement : public ITestSuite {
         void testConstruction_();
         void testExecution_();
+        void testParagraphWrapping_();
         void testLoopBreaks_();
         void testForEach_();
         void testSerialization_();
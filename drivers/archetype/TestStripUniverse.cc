@@ -0,0 +1,113 @@
+//
+//  TestStripUniverse.cc
+//  archetype
+//
+//
+
+#include <set>
+#include <string>
+
+#include "TestStripUniverse.hh"
+#include "TestRegistry.hh"
+#include "strip_universe.hh"
+#include "update_universe.hh"
+#include "Universe.hh"
+#include "SourceFile.hh"
+#include "TokenStream.hh"
+#include "StringOutput.hh"
+
+using namespace std;
+
+namespace archetype {
+    ARCHETYPE_TEST_REGISTER(TestStripUniverse);
+
+    static char program_library[] =
+    "type lamp_type based on null\n"
+    "  lit: FALSE\n"
+    "methods\n"
+    "  'light': { lit := TRUE; write \"The lamp is now lit.\" }\n"
+    "  'polish': write \"It gleams.\"\n"
+    "end\n"
+    "\n"
+    "type scroll_type based on null\n"
+    "methods\n"
+    "  'read': write \"Nobody reads this.\"\n"
+    "end\n"
+    "\n"
+    "lamp_type lamp end\n"
+    "scroll_type scroll end\n"
+    "\n"
+    "null main\n"
+    "methods\n"
+    "  'START': 'light' -> lamp\n"
+    "  'UPDATE': write \"Nothing happens.\"\n"
+    "end\n"
+    ;
+
+    static string run(string message) {
+        StringOutput* output = new StringOutput;
+        Universe::instance().setOutput(UserOutput{output});
+        dispatch_to_universe(message);
+        return output->getOutput();
+    }
+
+    void TestStripUniverse::testUnreachable_() {
+        Universe::destroy();
+        TokenStream t(make_source_from_str("library", program_library));
+        ARCHETYPE_TEST(Universe::instance().make(t));
+        Universe& u = Universe::instance();
+        ARCHETYPE_TEST(u.TextLiterals.has("Nobody reads this."));
+
+        StripReport report = strip_universe({});
+        // 'polish' is never sent, and nothing names the scroll or its type
+        ARCHETYPE_TEST_EQUAL(report.methods, 1);
+        ARCHETYPE_TEST_EQUAL(report.objects, 2);
+        ARCHETYPE_TEST(u.getObject("scroll") == nullptr);
+        ARCHETYPE_TEST(u.getObject("scroll_type") == nullptr);
+        ARCHETYPE_TEST(u.getObject("lamp") != nullptr);
+        ARCHETYPE_TEST(u.getObject("lamp_type") != nullptr);
+        ARCHETYPE_TEST(not u.Messages.has("polish"));
+        ARCHETYPE_TEST(not u.Messages.has("read"));
+        ARCHETYPE_TEST(u.Messages.has("light"));
+        ARCHETYPE_TEST(not u.TextLiterals.has("Nobody reads this."));
+        ARCHETYPE_TEST(not u.TextLiterals.has("It gleams."));
+
+        // What is left still runs, and survives a save and load
+        MemoryStorage saved;
+        saved << u;
+        Universe::destroy();
+        saved >> Universe::instance();
+        ARCHETYPE_TEST_EQUAL(run("START"), string{"The lamp is now lit.\n"});
+        ARCHETYPE_TEST_EQUAL(run("UPDATE"), string{"Nothing happens.\n"});
+    }
+
+    static char program_named[] =
+    "null main\n"
+    "  verb: \"jump\"\n"
+    "methods\n"
+    "  'START': verb -> self\n"
+    "  'jump': write \"Whee!\"\n"
+    "  'fly': write \"Flap.\"\n"
+    "  'swim': write \"Splash.\"\n"
+    "end\n"
+    ;
+
+    void TestStripUniverse::testNamedSends_() {
+        Universe::destroy();
+        TokenStream t(make_source_from_str("named", program_named));
+        ARCHETYPE_TEST(Universe::instance().make(t));
+        // 'jump' is only named by a string, and 'swim' only by the list of messages to keep
+        StripReport report = strip_universe({"swim"});
+        ARCHETYPE_TEST_EQUAL(report.methods, 1);
+        Universe& u = Universe::instance();
+        ARCHETYPE_TEST(u.Messages.has("jump"));
+        ARCHETYPE_TEST(u.Messages.has("swim"));
+        ARCHETYPE_TEST(not u.Messages.has("fly"));
+        ARCHETYPE_TEST_EQUAL(run("START"), string{"Whee!\n"});
+    }
+
+    void TestStripUniverse::runTests_() {
+        testUnreachable_();
+        testNamedSends_();
+    }
+}
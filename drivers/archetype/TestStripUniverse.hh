@@ -0,0 +1,26 @@
+//
+//  TestStripUniverse.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__TestStripUniverse__
+#define __archetype__TestStripUniverse__
+
+#include <iostream>
+#include <string>
+
+#include "ITestSuite.hh"
+
+namespace archetype {
+    class TestStripUniverse : public ITestSuite {
+        void testUnreachable_();
+        void testNamedSends_();
+    protected:
+        virtual void runTests_() override;
+    public:
+        TestStripUniverse(std::string name): ITestSuite(name) { }
+    };
+}
+
+#endif /* defined(__archetype__TestStripUniverse__) */
@@ -0,0 +1,108 @@
+//
+//  TestTrace.cc
+//  archetype
+//
+//
+
+#include <string>
+#include <sstream>
+
+#include "TestTrace.hh"
+#include "TestRegistry.hh"
+#include "Trace.hh"
+#include "Statement.hh"
+#include "Universe.hh"
+#include "SourceFile.hh"
+#include "TokenStream.hh"
+
+using namespace std;
+
+namespace archetype {
+    ARCHETYPE_TEST_REGISTER(TestTrace);
+
+    static char program_greeter[] =
+    "null greeter\n"
+    "  greeted: 0\n"
+    "methods\n"
+    "  'greet': {\n"
+    "    greeted +:= 1\n"
+    "    'wave' -> self\n"
+    "  }\n"
+    "  'wave': create null named waver\n"
+    "end\n"
+    ;
+
+    void TestTrace::testEvents_() {
+        Universe::destroy();
+        Trace::destroy();
+        TokenStream t(make_source_from_str("greeter", program_greeter));
+        ARCHETYPE_TEST(Universe::instance().make(t));
+        Statement stmt = make_stmt_from_str("'greet' -> greeter");
+
+        Trace::instance().enable(64);
+        stmt->execute();
+        Trace::instance().disable();
+        // Nothing is recorded while disabled.
+        stmt->execute();
+
+        int greeter_id = Universe::instance().getObject("greeter")->id();
+        int greeted_id = Universe::instance().Identifiers.index("greeted");
+        vector<Trace::Record> records = Trace::instance().records();
+        int sends = 0, dispatches = 0, reads = 0, writes = 0, creates = 0;
+        for (auto const& r : records) {
+            switch (r.event) {
+                case Trace::SEND: sends++; break;
+                case Trace::DISPATCH: dispatches++; break;
+                case Trace::READ_ATTRIBUTE:
+                    ARCHETYPE_TEST_EQUAL(r.object, greeter_id);
+                    ARCHETYPE_TEST_EQUAL(r.argument, greeted_id);
+                    reads++;
+                    break;
+                case Trace::WRITE_ATTRIBUTE:
+                    ARCHETYPE_TEST_EQUAL(r.object, greeter_id);
+                    writes++;
+                    break;
+                case Trace::CREATE:
+                    ARCHETYPE_TEST_EQUAL(r.argument, 0);
+                    creates++;
+                    break;
+            }
+        }
+        ARCHETYPE_TEST_EQUAL(sends, 2);
+        ARCHETYPE_TEST_EQUAL(dispatches, 2);
+        ARCHETYPE_TEST(reads >= 1);
+        ARCHETYPE_TEST_EQUAL(writes, 1);
+        ARCHETYPE_TEST_EQUAL(creates, 1);
+        ARCHETYPE_TEST(not records.empty() and records.front().event == Trace::SEND);
+        for (size_t i = 1; i < records.size(); ++i) {
+            ARCHETYPE_TEST(records[i - 1].nanoseconds <= records[i].nanoseconds);
+        }
+
+        ostringstream out;
+        Trace::instance().dump(out);
+        ARCHETYPE_TEST(out.str().find("dispatch  greeter 'greet'") != string::npos);
+        ARCHETYPE_TEST(out.str().find("write     greeter.greeted") != string::npos);
+        Trace::destroy();
+    }
+
+    void TestTrace::testWrapping_() {
+        Trace::destroy();
+        Trace::instance().enable(8);
+        for (int i = 0; i < 20; ++i) {
+            Trace::instance().record(Trace::DESTROY, i);
+        }
+        Trace::instance().disable();
+        vector<Trace::Record> records = Trace::instance().records();
+        ARCHETYPE_TEST_EQUAL(records.size(), size_t(8));
+        // Only the most recent events survive, oldest first.
+        for (size_t i = 0; i < records.size(); ++i) {
+            ARCHETYPE_TEST_EQUAL(records[i].object, int(12 + i));
+        }
+        Trace::destroy();
+    }
+
+    void TestTrace::runTests_() {
+        testEvents_();
+        testWrapping_();
+    }
+}
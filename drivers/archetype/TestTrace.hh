@@ -0,0 +1,26 @@
+//
+//  TestTrace.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__TestTrace__
+#define __archetype__TestTrace__
+
+#include <iostream>
+#include <string>
+
+#include "ITestSuite.hh"
+
+namespace archetype {
+    class TestTrace : public ITestSuite {
+        void testEvents_();
+        void testWrapping_();
+    protected:
+        virtual void runTests_() override;
+    public:
+        TestTrace(std::string name): ITestSuite(name) { }
+    };
+}
+
+#endif /* defined(__archetype__TestTrace__) */
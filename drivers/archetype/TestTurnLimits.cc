@@ -0,0 +1,118 @@
+//
+//  TestTurnLimits.cc
+//  archetype
+//
+//
+
+#include <string>
+
+#include "TestTurnLimits.hh"
+#include "TestRegistry.hh"
+#include "TurnLimits.hh"
+#include "Statement.hh"
+#include "Universe.hh"
+#include "SourceFile.hh"
+#include "TokenStream.hh"
+#include "update_universe.hh"
+
+using namespace std;
+
+namespace archetype {
+    ARCHETYPE_TEST_REGISTER(TestTurnLimits);
+
+    static char program_runaway[] =
+    "null main\n"
+    "  n: 0\n"
+    "  depth: 0\n"
+    "methods\n"
+    "  'spin': while n >= 0 do n +:= 1\n"
+    "  'recurse': { depth +:= 1; 'recurse' -> self; depth }\n"
+    "  'step': if n < 5000 then { n +:= 1; 'step' -> self }\n"
+    "  'UPDATE': { n := 7; 'spin' -> self }\n"
+    "end\n"
+    ;
+
+    void TestTurnLimits::testStatements_() {
+        Universe::destroy();
+        TurnLimits::destroy();
+        TokenStream t(make_source_from_str("runaway", program_runaway));
+        ARCHETYPE_TEST(Universe::instance().make(t));
+        Statement stmt = make_stmt_from_str("'spin' -> main");
+
+        TurnLimits::instance().setMaxStatements(1000);
+        bool exceeded = false;
+        try {
+            stmt->execute();
+        } catch (const TurnLimitExceeded&) {
+            exceeded = true;
+        }
+        ARCHETYPE_TEST(exceeded);
+        ARCHETYPE_TEST_EQUAL(TurnLimits::instance().statements(), 1001LL);
+
+        // The clock is only looked at every so often, but a loop that never ends
+        // is still caught.
+        TurnLimits::instance().setMaxStatements(0);
+        TurnLimits::instance().setMaxMilliseconds(5);
+        exceeded = false;
+        try {
+            stmt->execute();
+        } catch (const TurnLimitExceeded&) {
+            exceeded = true;
+        }
+        ARCHETYPE_TEST(exceeded);
+        TurnLimits::destroy();
+    }
+
+    void TestTurnLimits::testSendDepth_() {
+        Universe::destroy();
+        TurnLimits::destroy();
+        TokenStream t(make_source_from_str("runaway", program_runaway));
+        ARCHETYPE_TEST(Universe::instance().make(t));
+        Statement stmt = make_stmt_from_str("'recurse' -> main");
+
+        TurnLimits::instance().setMaxSendDepth(50);
+        bool exceeded = false;
+        try {
+            stmt->execute();
+        } catch (const TurnLimitExceeded&) {
+            exceeded = true;
+        }
+        ARCHETYPE_TEST(exceeded);
+        ARCHETYPE_TEST_EQUAL(make_stmt_from_str("main.depth")->execute()->numericConversion()->getNumber(), 50);
+        // Every level is unwound.
+        ARCHETYPE_TEST_EQUAL(TurnLimits::instance().sendDepth(), 0);
+
+        // Sends in tail position take no more stack, so are not nested at all.
+        make_stmt_from_str("'step' -> main")->execute();
+        ARCHETYPE_TEST_EQUAL(make_stmt_from_str("main.n")->execute()->numericConversion()->getNumber(), 5000);
+        ARCHETYPE_TEST_EQUAL(TurnLimits::instance().sendDepth(), 0);
+        TurnLimits::destroy();
+    }
+
+    void TestTurnLimits::testRollback_() {
+        Universe::destroy();
+        TurnLimits::destroy();
+        TokenStream t(make_source_from_str("runaway", program_runaway));
+        ARCHETYPE_TEST(Universe::instance().make(t));
+        MemoryStorage in;
+        in << Universe::instance();
+
+        TurnLimits::instance().setMaxStatements(1000);
+        MemoryStorage out;
+        string output = update_universe(in, out, "");
+        ARCHETYPE_TEST(output.find("Turn abandoned") != string::npos);
+
+        // The turn never happened.
+        Universe::destroy();
+        out >> Universe::instance();
+        ARCHETYPE_TEST_EQUAL(make_stmt_from_str("main.n")->execute()->numericConversion()->getNumber(), 0);
+        TurnLimits::destroy();
+        Universe::destroy();
+    }
+
+    void TestTurnLimits::runTests_() {
+        testStatements_();
+        testSendDepth_();
+        testRollback_();
+    }
+}
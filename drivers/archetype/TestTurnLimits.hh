@@ -0,0 +1,27 @@
+//
+//  TestTurnLimits.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__TestTurnLimits__
+#define __archetype__TestTurnLimits__
+
+#include <iostream>
+#include <string>
+
+#include "ITestSuite.hh"
+
+namespace archetype {
+    class TestTurnLimits : public ITestSuite {
+        void testStatements_();
+        void testSendDepth_();
+        void testRollback_();
+    protected:
+        virtual void runTests_() override;
+    public:
+        TestTurnLimits(std::string name): ITestSuite(name) { }
+    };
+}
+
+#endif /* defined(__archetype__TestTurnLimits__) */
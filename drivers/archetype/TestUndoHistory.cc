@@ -0,0 +1,214 @@
+//
+//  TestUndoHistory.cc
+//  archetype
+//
+//
+
+#include <string>
+
+#include "TestUndoHistory.hh"
+#include "TestRegistry.hh"
+#include "UndoHistory.hh"
+#include "Statement.hh"
+#include "Universe.hh"
+#include "update_universe.hh"
+#include "StringInput.hh"
+#include "StringOutput.hh"
+#include "SourceFile.hh"
+#include "TokenStream.hh"
+
+using namespace std;
+
+namespace archetype {
+    ARCHETYPE_TEST_REGISTER(TestUndoHistory);
+
+    static char program_room[] =
+    "type thing based on null\n"
+    "  location: UNDEFINED\n"
+    "end\n"
+    "null room\n"
+    "  visits: 0\n"
+    "end\n"
+    "thing lamp location: room end\n"
+    "thing rug location: room end\n"
+    "null player\n"
+    "  carrying: UNDEFINED\n"
+    "end\n"
+    ;
+
+    static char program_turns[] =
+    "null main\n"
+    "  turns: 0\n"
+    "methods\n"
+    "  'UPDATE':\n"
+    "    if read = \"undo\" then\n"
+    "      if 'UNDO' -> system then write \"Undone.\" else write \"Nothing to undo.\"\n"
+    "    else {\n"
+    "      turns +:= 1\n"
+    "      write \"Turn \", turns\n"
+    "    }\n"
+    "end\n"
+    ;
+
+    static string turn(string input) {
+        UserOutput output{new StringOutput};
+        Universe::instance().setOutput(output);
+        Universe::instance().setInput(UserInput{new StringInput{input + "\n"}});
+        dispatch_to_universe("UPDATE");
+        return dynamic_cast<StringOutput*>(output.get())->getOutput();
+    }
+
+    static vector<Storage::Byte> saved_universe() {
+        MemoryStorage mem;
+        mem << Universe::instance();
+        return mem.bytes();
+    }
+
+    static int number(string expr) {
+        return make_stmt_from_str(expr)->execute()->numericConversion()->getNumber();
+    }
+
+    void TestUndoHistory::testUndo_() {
+        Universe::destroy();
+        TokenStream t(make_source_from_str("room", program_room));
+        ARCHETYPE_TEST(Universe::instance().make(t));
+        Statement snapshot = make_stmt_from_str("'SNAPSHOT' -> system");
+        Statement undo = make_stmt_from_str("'UNDO' -> system");
+        Statement turn = make_stmt_from_str("{ room.visits +:= 1; lamp.location := player;"
+                                            " create thing named player.carrying; destroy rug }");
+
+        ARCHETYPE_TEST(not undo->execute()->isTrueEnough());
+        vector<Storage::Byte> before = saved_universe();
+        ARCHETYPE_TEST(snapshot->execute()->isTrueEnough());
+
+        turn->execute();
+        ARCHETYPE_TEST_EQUAL(number("room.visits"), 1);
+        ARCHETYPE_TEST(not make_stmt_from_str("rug.location")->execute()->isDefined());
+
+        ARCHETYPE_TEST(undo->execute()->isTrueEnough());
+        ARCHETYPE_TEST_EQUAL(number("room.visits"), 0);
+        ARCHETYPE_TEST(make_stmt_from_str("rug.location")->execute()->isDefined());
+        ARCHETYPE_TEST(not make_stmt_from_str("player.carrying")->execute()->isDefined());
+        // Everything is as it was, down to what would be saved.
+        ARCHETYPE_TEST(saved_universe() == before);
+        ARCHETYPE_TEST(not UndoHistory::Recording);
+        Universe::destroy();
+    }
+
+    void TestUndoHistory::testLevels_() {
+        Universe::destroy();
+        TokenStream t(make_source_from_str("room", program_room));
+        ARCHETYPE_TEST(Universe::instance().make(t));
+        Statement snapshot = make_stmt_from_str("'SNAPSHOT' -> system");
+        Statement undo = make_stmt_from_str("'UNDO' -> system");
+        Statement visit = make_stmt_from_str("room.visits +:= 1");
+
+        UndoHistory& history = Universe::instance().History;
+        history.setCapacity(3);
+        for (int i = 0; i < 5; ++i) {
+            snapshot->execute();
+            visit->execute();
+        }
+        ARCHETYPE_TEST_EQUAL(number("room.visits"), 5);
+        ARCHETYPE_TEST_EQUAL(history.snapshots(), 3);
+
+        // Only the last three turns are remembered.
+        ARCHETYPE_TEST(undo->execute()->isTrueEnough());
+        ARCHETYPE_TEST_EQUAL(number("room.visits"), 4);
+        ARCHETYPE_TEST(undo->execute()->isTrueEnough());
+        ARCHETYPE_TEST(undo->execute()->isTrueEnough());
+        ARCHETYPE_TEST_EQUAL(number("room.visits"), 2);
+        ARCHETYPE_TEST(not undo->execute()->isTrueEnough());
+        ARCHETYPE_TEST_EQUAL(number("room.visits"), 2);
+        Universe::destroy();
+    }
+
+    void TestUndoHistory::testUnset_() {
+        Universe::destroy();
+        TokenStream t(make_source_from_str("room", program_room));
+        ARCHETYPE_TEST(Universe::instance().make(t));
+        Statement snapshot = make_stmt_from_str("'SNAPSHOT' -> system");
+        Statement undo = make_stmt_from_str("'UNDO' -> system");
+        Expression location = make_expr_from_str("player.location");
+        Statement place = make_stmt_from_str("player.location := room");
+
+        // Reading an attribute nothing holds marks it unset, and undoing that
+        // unmarks it.
+        ARCHETYPE_TEST(not undo->execute()->isTrueEnough());
+        vector<Storage::Byte> before = saved_universe();
+        snapshot->execute();
+        ARCHETYPE_TEST(not location->evaluate()->valueConversion()->isDefined());
+        place->execute();
+        ARCHETYPE_TEST(undo->execute()->isTrueEnough());
+        ARCHETYPE_TEST(saved_universe() == before);
+
+        // Writing one that was marked puts the mark back when undone.
+        ARCHETYPE_TEST(not location->evaluate()->valueConversion()->isDefined());
+        before = saved_universe();
+        snapshot->execute();
+        place->execute();
+        ARCHETYPE_TEST(location->evaluate()->valueConversion()->isDefined());
+        ARCHETYPE_TEST(undo->execute()->isTrueEnough());
+        ARCHETYPE_TEST(not location->evaluate()->valueConversion()->isDefined());
+        ARCHETYPE_TEST(saved_universe() == before);
+        Universe::destroy();
+    }
+
+    void TestUndoHistory::testAppend_() {
+        Universe::destroy();
+        TokenStream t(make_source_from_str("room", program_room));
+        ARCHETYPE_TEST(Universe::instance().make(t));
+        // Built by appending, the text is held only by the attribute.
+        make_stmt_from_str("{ player.carrying := \"la\"; player.carrying &:= \"mp\" }")->execute();
+        Statement snapshot = make_stmt_from_str("'SNAPSHOT' -> system");
+        Statement undo = make_stmt_from_str("'UNDO' -> system");
+        Statement append = make_stmt_from_str("player.carrying &:= \" and rug\"");
+        Expression carrying = make_expr_from_str("player.carrying");
+        ARCHETYPE_TEST(not undo->execute()->isTrueEnough());
+        vector<Storage::Byte> before = saved_universe();
+        const IValue* text = carrying->evaluate()->valueConversion().get();
+
+        // While recording, the text still grows where it is.
+        snapshot->execute();
+        append->execute();
+        ARCHETYPE_TEST(carrying->evaluate()->valueConversion().get() == text);
+        ARCHETYPE_TEST_EQUAL(carrying->evaluate()->valueConversion()->getString(), string("lamp and rug"));
+        ARCHETYPE_TEST(undo->execute()->isTrueEnough());
+        ARCHETYPE_TEST_EQUAL(carrying->evaluate()->valueConversion()->getString(), string("lamp"));
+        ARCHETYPE_TEST(saved_universe() == before);
+        Universe::destroy();
+    }
+
+    void TestUndoHistory::testTurns_() {
+        Universe::destroy();
+        TokenStream t(make_source_from_str("turns", program_turns));
+        ARCHETYPE_TEST(Universe::instance().make(t));
+
+        // Unless asked for, turns take no snapshots.
+        ARCHETYPE_TEST_EQUAL(turn("look"), string("Turn 1\n"));
+        ARCHETYPE_TEST_EQUAL(Universe::instance().History.snapshots(), 0);
+        ARCHETYPE_TEST_EQUAL(turn("undo"), string("Nothing to undo.\n"));
+
+        // Undoing during a turn goes back to the start of the turn before.
+        UndoHistory::EveryTurn = true;
+        ARCHETYPE_TEST_EQUAL(turn("look"), string("Turn 2\n"));
+        ARCHETYPE_TEST_EQUAL(turn("look"), string("Turn 3\n"));
+        ARCHETYPE_TEST_EQUAL(turn("undo"), string("Undone.\n"));
+        ARCHETYPE_TEST_EQUAL(number("main.turns"), 2);
+        ARCHETYPE_TEST_EQUAL(turn("look"), string("Turn 3\n"));
+        ARCHETYPE_TEST_EQUAL(turn("undo"), string("Undone.\n"));
+        ARCHETYPE_TEST_EQUAL(turn("undo"), string("Undone.\n"));
+        ARCHETYPE_TEST_EQUAL(turn("undo"), string("Nothing to undo.\n"));
+        ARCHETYPE_TEST_EQUAL(number("main.turns"), 1);
+        UndoHistory::EveryTurn = false;
+        Universe::destroy();
+    }
+
+    void TestUndoHistory::runTests_() {
+        testUndo_();
+        testLevels_();
+        testUnset_();
+        testAppend_();
+        testTurns_();
+    }
+}
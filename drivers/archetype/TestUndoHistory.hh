@@ -0,0 +1,29 @@
+//
+//  TestUndoHistory.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__TestUndoHistory__
+#define __archetype__TestUndoHistory__
+
+#include <iostream>
+#include <string>
+
+#include "ITestSuite.hh"
+
+namespace archetype {
+    class TestUndoHistory : public ITestSuite {
+        void testUndo_();
+        void testLevels_();
+        void testUnset_();
+        void testAppend_();
+        void testTurns_();
+    protected:
+        virtual void runTests_() override;
+    public:
+        TestUndoHistory(std::string name): ITestSuite(name) { }
+    };
+}
+
+#endif /* defined(__archetype__TestUndoHistory__) */
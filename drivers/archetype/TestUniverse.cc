@@ -6,6 +6,7 @@
 //  Copyright (c) 2014 Derek Jones. All rights reserved.
 //
 
+#include <iterator>
 #include <string>
 #include <sstream>
 #include <memory>
@@ -18,6 +19,8 @@
 #include "TokenStream.hh"
 #include "Wellspring.hh"
 #include "Capture.hh"
+#include "StringOutput.hh"
+#include "update_universe.hh"
 
 using namespace std;
 
@@ -381,6 +384,104 @@ namespace archetype {
         ARCHETYPE_TEST(not remote);
     }
 
+    static char program_binding[] =
+    "keyword north\n"
+    "null lamp\n"
+    "  desc: \"lamp\"\n"
+    "methods\n"
+    "  'show': write desc, \" \", north = north\n"
+    "end\n"
+    "null box\n"
+    "  desc: \"box\"\n"
+    "end\n"
+    "null shelf\n"
+    "  box: \"shelf box\"\n"
+    "methods\n"
+    "  'show': write box\n"
+    "end\n"
+    "null tester\n"
+    "methods\n"
+    "  'show': write box.desc, \" \", lamp.desc\n"
+    "end\n"
+    ;
+
+    static string show_all() {
+        Capture shown;
+        for (auto target : {"lamp", "shelf", "tester"}) {
+            make_stmt_from_str(string("'show' -> ") + target)->execute();
+        }
+        return shown.getCapture();
+    }
+
+    void TestUniverse::testIdentifierBinding_() {
+        Universe::destroy();
+        TokenStream t(make_source_from_str("binding", program_binding));
+        ARCHETYPE_TEST(Universe::instance().make(t));
+        Universe& u = Universe::instance();
+        ARCHETYPE_TEST_EQUAL(u.identifierKind(u.Identifiers.find("north")), KEYWORD_ID);
+        ARCHETYPE_TEST_EQUAL(u.identifierKind(u.Identifiers.find("lamp")), OBJECT_ID);
+        ARCHETYPE_TEST_EQUAL(u.identifierKind(u.Identifiers.find("desc")), DEFINED_ATTRIBUTE_ID);
+        // Both an object and an attribute, so only evaluation can tell which is meant
+        ARCHETYPE_TEST_EQUAL(u.identifierKind(u.Identifiers.find("box")), AMBIGUOUS_ID);
+
+        string expected = "lamp TRUE\nshelf box\nbox lamp\n";
+        ARCHETYPE_TEST_EQUAL(show_all(), expected);
+        u.bindIdentifiers();
+        ARCHETYPE_TEST_EQUAL(show_all(), expected);
+
+        // What each identifier names is saved with the program
+        MemoryStorage mem;
+        mem << u;
+        Universe::destroy();
+        mem >> Universe::instance();
+        Universe& loaded = Universe::instance();
+        ARCHETYPE_TEST_EQUAL(loaded.identifierKind(loaded.Identifiers.find("north")), KEYWORD_ID);
+        ARCHETYPE_TEST_EQUAL(loaded.identifierKind(loaded.Identifiers.find("box")), AMBIGUOUS_ID);
+        ARCHETYPE_TEST_EQUAL(show_all(), expected);
+    }
+
+    // Saved, before Universes had versions, after one 'UPDATE' of:
+    //   null main
+    //     count: 0
+    //   methods
+    //     'UPDATE': { count +:= 1; write "Turn ", count, " and ", other }
+    //   end
+    static const unsigned char unversioned_universe[] = {
+        0x00, 0x02, 0x02, 0x00, 0x0c, 0x55, 0x50, 0x44, 0x41, 0x54, 0x45, 0x04, 0x04, 0x02, 0x0a, 0x20,
+        0x61, 0x6e, 0x64, 0x20, 0x00, 0x0a, 0x54, 0x75, 0x72, 0x6e, 0x20, 0x0a, 0x0a, 0x06, 0x0a, 0x63,
+        0x6f, 0x75, 0x6e, 0x74, 0x04, 0x08, 0x6d, 0x61, 0x69, 0x6e, 0x00, 0x08, 0x6e, 0x75, 0x6c, 0x6c,
+        0x08, 0x0a, 0x6f, 0x74, 0x68, 0x65, 0x72, 0x02, 0x0c, 0x73, 0x79, 0x73, 0x74, 0x65, 0x6d, 0x06,
+        0x00, 0x00, 0x02, 0x02, 0x04, 0x04, 0x06, 0x06, 0x00, 0x02, 0x03, 0x00, 0x02, 0x00, 0x00, 0x02,
+        0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x02, 0x00, 0x04,
+        0x00, 0x02, 0x06, 0x08, 0x0c, 0x02, 0x02, 0x00, 0x00, 0x04, 0x02, 0x04, 0x0c, 0x06, 0x06, 0x08,
+        0x0c, 0x02, 0x10, 0x42, 0x08, 0x08, 0x0a, 0x00, 0x06, 0x06, 0x08, 0x0a, 0x02, 0x06, 0x08
+    };
+
+    void TestUniverse::testUnversioned_() {
+        Universe::destroy();
+        MemoryStorage mem;
+        mem.bytes().assign(begin(unversioned_universe), end(unversioned_universe));
+        mem >> Universe::instance();
+        Universe& u = Universe::instance();
+        // Nothing says what identifiers name, so they are looked up as they run
+        ARCHETYPE_TEST_EQUAL(u.identifierKind(u.Identifiers.find("count")), UNKNOWN_ID);
+        StringOutput* output = new StringOutput;
+        u.setOutput(UserOutput{output});
+        dispatch_to_universe("UPDATE");
+        ARCHETYPE_TEST_EQUAL(output->getOutput(), string{"Turn 2 and \n"});
+
+        // Saving it again writes the current version, which reads back the same
+        MemoryStorage saved;
+        saved << u;
+        Universe::destroy();
+        saved >> Universe::instance();
+        output = new StringOutput;
+        Universe::instance().setOutput(UserOutput{output});
+        dispatch_to_universe("UPDATE");
+        ARCHETYPE_TEST_EQUAL(output->getOutput(), string{"Turn 3 and \n"});
+        Universe::destroy();
+    }
+
     void TestUniverse::runTests_() {
         testBasicObjects_();
         testNullIsNull_();
@@ -389,5 +490,7 @@ namespace archetype {
         testDefaultMethods_();
         testMessagingKeywords_();
         testSerialization_();
+        testIdentifierBinding_();
+        testUnversioned_();
     }
 }
@@ -22,6 +22,8 @@ namespace archetype {
         void testDefaultMethods_();
         void testMessagingKeywords_();
         void testSerialization_();
+        void testIdentifierBinding_();
+        void testUnversioned_();
     protected:
         virtual void runTests_() override;
     public:
@@ -0,0 +1,143 @@
+//
+//  TestUpdateUniverse.cc
+//  archetype
+//
+//
+
+#include <string>
+#include <vector>
+
+#include "TestUpdateUniverse.hh"
+#include "TestRegistry.hh"
+#include "update_universe.hh"
+#include "Statement.hh"
+#include "Universe.hh"
+#include "SourceFile.hh"
+#include "TokenStream.hh"
+
+using namespace std;
+
+namespace archetype {
+    ARCHETYPE_TEST_REGISTER(TestUpdateUniverse);
+
+    static char program_questions[] =
+    "null main\n"
+    "  turns: 0\n"
+    "  command: UNDEFINED\n"
+    "  name: UNDEFINED\n"
+    "methods\n"
+    "  'UPDATE': {\n"
+    "    turns +:= 1\n"
+    "    command := read\n"
+    "    >>Name? \n"
+    "    name := read\n"
+    "    >>Sure? \n"
+    "    if key = \"y\" then write \"Hello, \", name else write \"Never mind.\"\n"
+    "  }\n"
+    "end\n"
+    ;
+
+    static char program_dice[] =
+    "null main\n"
+    "  rolled: 0\n"
+    "methods\n"
+    "  'UPDATE': { read; rolled := ?1000000; write rolled; >>Again? \n read; write \"Still \", rolled }\n"
+    "end\n"
+    ;
+
+    static char program_counter[] =
+    "null main\n"
+    "  turns: 0\n"
+    "methods\n"
+    "  'UPDATE': { read; write \"Turn \", turns; >>Go on? \n read; turns +:= 1 }\n"
+    "end\n"
+    ;
+
+    static string play(MemoryStorage& game, string input) {
+        MemoryStorage out;
+        string output = update_universe(game, out, input);
+        game = MemoryStorage();
+        game.bytes() = out.bytes();
+        return output;
+    }
+
+    void TestUpdateUniverse::testSuspension_() {
+        Universe::destroy();
+        TokenStream t(make_source_from_str("questions", program_questions));
+        ARCHETYPE_TEST(Universe::instance().make(t));
+        MemoryStorage game;
+        game << Universe::instance();
+
+        // Each answer finishes as much of the turn as it can.
+        string out1 = play(game, "wave");
+        ARCHETYPE_TEST_EQUAL(out1, string("wave\nName? \n"));
+        string out2 = play(game, "Ada");
+        ARCHETYPE_TEST_EQUAL(out2, string("Ada\nSure? \n"));
+        string out3 = play(game, "y");
+        ARCHETYPE_TEST_EQUAL(out3, string("yHello, Ada\n"));
+
+        // The suspended turn was only counted once it finished.
+        Universe::destroy();
+        game >> Universe::instance();
+        ARCHETYPE_TEST_EQUAL(make_stmt_from_str("main.turns")->execute()->numericConversion()->getNumber(), 1);
+        ARCHETYPE_TEST_EQUAL(make_stmt_from_str("main.name")->execute()->stringConversion()->getString(), string("Ada"));
+        Universe::destroy();
+    }
+
+    void TestUpdateUniverse::testRandomRepeats_() {
+        Universe::destroy();
+        TokenStream t(make_source_from_str("dice", program_dice));
+        ARCHETYPE_TEST(Universe::instance().make(t));
+        MemoryStorage game;
+        game << Universe::instance();
+
+        // The number rolled before the question is rolled again when the turn
+        // resumes, so what was already shown stays true.
+        string out1 = play(game, "roll");
+        string out2 = play(game, "again");
+        string rolled = out1.substr(out1.find('\n') + 1);
+        rolled = rolled.substr(0, rolled.find('\n'));
+        ARCHETYPE_TEST(not rolled.empty());
+        ARCHETYPE_TEST_EQUAL(out2, string("again\nStill " + rolled + "\n"));
+        Universe::destroy();
+    }
+
+    void TestUpdateUniverse::testDivergence_() {
+        Universe::destroy();
+        TokenStream t(make_source_from_str("counter", program_counter));
+        ARCHETYPE_TEST(Universe::instance().make(t));
+        MemoryStorage game;
+        game << Universe::instance();
+        ARCHETYPE_TEST_EQUAL(play(game, "go"), string("go\nTurn 0\nGo on? \n"));
+
+        // Change the Universe under the suspended turn, so that it no longer
+        // shows what it did before the question.
+        MemoryStorage original;
+        original.bytes() = game.bytes();
+        Universe::destroy();
+        original >> Universe::instance();
+        vector<Storage::Byte> suspended(original.bytes().end() - original.remaining(), original.bytes().end());
+        make_stmt_from_str("main.turns := 5")->execute();
+        MemoryStorage changed;
+        changed << Universe::instance();
+        changed.write(suspended.data(), static_cast<int>(suspended.size()));
+
+        // The turn is abandoned rather than finished, and the next begins afresh.
+        ARCHETYPE_TEST_EQUAL(play(changed, "yes"), string("That turn could not be resumed, so it was abandoned.\n"));
+        ARCHETYPE_TEST_EQUAL(play(changed, "go"), string("go\nTurn 5\nGo on? \n"));
+        ARCHETYPE_TEST_EQUAL(play(changed, "yes"), string("yes\n"));
+        Universe::destroy();
+        changed >> Universe::instance();
+        ARCHETYPE_TEST_EQUAL(make_stmt_from_str("main.turns")->execute()->numericConversion()->getNumber(), 6);
+
+        // Unchanged, the same turn resumes as usual.
+        ARCHETYPE_TEST_EQUAL(play(game, "yes"), string("yes\n"));
+        Universe::destroy();
+    }
+
+    void TestUpdateUniverse::runTests_() {
+        testSuspension_();
+        testRandomRepeats_();
+        testDivergence_();
+    }
+}
@@ -0,0 +1,27 @@
+//
+//  TestUpdateUniverse.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__TestUpdateUniverse__
+#define __archetype__TestUpdateUniverse__
+
+#include <iostream>
+#include <string>
+
+#include "ITestSuite.hh"
+
+namespace archetype {
+    class TestUpdateUniverse : public ITestSuite {
+        void testSuspension_();
+        void testRandomRepeats_();
+        void testDivergence_();
+    protected:
+        virtual void runTests_() override;
+    public:
+        TestUpdateUniverse(std::string name): ITestSuite(name) { }
+    };
+}
+
+#endif /* defined(__archetype__TestUpdateUniverse__) */
@@ -13,6 +13,7 @@
 #include "TestValue.hh"
 #include "TestRegistry.hh"
 #include "Value.hh"
+#include "Expression.hh"
 #include "Serialization.hh"
 #include "Universe.hh"
 
@@ -72,6 +73,26 @@ namespace archetype {
         // though this makes it much harder to test Value by itself
         Universe::destroy();
         // set up objects, identifiers, messages
+
+        // A text literal is read straight out of the literal table
+        int lamp = Universe::instance().TextLiterals.index("brass lamp");
+        Value literal{new TextLiteralValue{lamp}};
+        Value literal_string = literal->stringConversion();
+        ARCHETYPE_TEST(literal_string.get() == literal.get());
+        ARCHETYPE_TEST(&literal->getString() == &Universe::instance().TextLiterals.get(lamp));
+        Value copied{new StringValue{"brass lamp"}};
+        ARCHETYPE_TEST(literal->isSameValueAs(copied));
+        ARCHETYPE_TEST(copied->isSameValueAs(literal));
+
+        // The message a string names is found once, and the string goes on
+        // looking only for as long as there is no such message
+        ARCHETYPE_TEST(not literal->messageConversion()->isDefined());
+        int lamp_message = Universe::instance().Messages.index("brass lamp");
+        Value first = literal->messageConversion();
+        ARCHETYPE_TEST(first->isDefined());
+        ARCHETYPE_TEST_EQUAL(first->getMessage(), lamp_message);
+        ARCHETYPE_TEST(literal->messageConversion().get() == first.get());
+        ARCHETYPE_TEST_EQUAL(copied->messageConversion()->getMessage(), lamp_message);
     }
 
     void TestValue::testPairs_() {
@@ -91,11 +112,53 @@ namespace archetype {
         actual = display(node2);
         expected = "{\"hello\" \"world\"}";
         ARCHETYPE_TEST_EQUAL(actual, expected);
+
+        // Copies share their pairs, and taking a list apart leaves it whole
+        Value copy = node2->clone();
+        ARCHETYPE_TEST(copy.get() == node2.get());
+        ARCHETYPE_TEST(copy->isSameValueAs(node2));
+        Value rest = copy->tail();
+        ARCHETYPE_TEST(rest.get() == copy->tail().get());
+        ARCHETYPE_TEST_EQUAL(display(rest), string{"{\"world\"}"});
+        ARCHETYPE_TEST_EQUAL(display(copy), expected);
+        Value other{new PairValue{Value{new StringValue{"hello"}}, rest->clone()}};
+        ARCHETYPE_TEST(other->isSameValueAs(node2));
+        Value different{new PairValue{Value{new StringValue{"hello"}}, Value{new UndefinedValue}}};
+        ARCHETYPE_TEST(not different->isSameValueAs(node2));
+        ARCHETYPE_TEST(not node2->isSameValueAs(different));
+
+        MemoryStorage mem;
+        mem << node2;
+        Value read_back;
+        mem >> read_back;
+        ARCHETYPE_TEST(read_back->isSameValueAs(node2));
+    }
+
+    void TestValue::testSharing_() {
+        Value text{new StringValue{"brass lamp"}};
+        Value copy = text->clone();
+        ARCHETYPE_TEST(copy.get() == text.get());
+        text.reset();
+        ARCHETYPE_TEST_EQUAL(copy->getString(), string{"brass lamp"});
+
+        Value moved = std::move(copy);
+        ARCHETYPE_TEST(copy == nullptr);
+        ARCHETYPE_TEST(moved != nullptr);
+        moved = moved->stringConversion();
+        ARCHETYPE_TEST_EQUAL(moved->getString(), string{"brass lamp"});
+
+        // Reading a constant hands back the constant itself
+        Expression constant{new ValueExpression{Value{new NumericValue{42}}}};
+        Value first = constant->evaluate();
+        Value second = constant->evaluate();
+        ARCHETYPE_TEST(first.get() == second.get());
+        ARCHETYPE_TEST_EQUAL(first->getNumber(), 42);
     }
 
     void TestValue::runTests_() {
         testSerialization_();
         testConversion_();
         testPairs_();
+        testSharing_();
     }
 }
@@ -18,6 +18,7 @@ namespace archetype {
         void testSerialization_();
         void testConversion_();
         void testPairs_();
+        void testSharing_();
     protected:
         virtual void runTests_() override;
     public:
@@ -50,7 +50,33 @@ namespace archetype {
         out() << "TestWrappedOutput finished." << endl;
     }
 
+    void TestWrappedOutput::testUnbreakable_() {
+        UserOutput user_soutput{new StringOutput};
+        StringOutput& strout(*dynamic_cast<StringOutput*>(user_soutput.get()));
+        UserOutput user_output{new WrappedOutput{user_soutput, 10}};
+        // Too long for any one line, so it must be split mid-word.
+        user_output->put("Supercalifragilistic is a word.");
+        user_output->endLine();
+        ARCHETYPE_TEST_EQUAL(strout.getOutput(), string("Supercalif\nragilistic\nis a word.\n"));
+    }
+
+    void TestWrappedOutput::testSuccessivePuts_() {
+        UserOutput user_soutput{new StringOutput};
+        StringOutput& strout(*dynamic_cast<StringOutput*>(user_soutput.get()));
+        UserOutput user_output{new WrappedOutput{user_soutput, 12}};
+        // Each put continues from the column where the last one left off,
+        // and trailing punctuation may run a little into the margin.
+        user_output->put("You see ");
+        user_output->put("a lamp");
+        user_output->put(".");
+        user_output->put(" It is lit and warm.");
+        user_output->endLine();
+        ARCHETYPE_TEST_EQUAL(strout.getOutput(), string("You see a\nlamp. It is\nlit and\nwarm.\n"));
+    }
+
     void TestWrappedOutput::runTests_() {
         testBasicWrap_();
+        testUnbreakable_();
+        testSuccessivePuts_();
     }
 }
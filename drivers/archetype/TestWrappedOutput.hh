@@ -14,6 +14,8 @@
 namespace archetype {
     class TestWrappedOutput : public ITestSuite {
         void testBasicWrap_();
+        void testUnbreakable_();
+        void testSuccessivePuts_();
     protected:
         virtual void runTests_() override;
     public:
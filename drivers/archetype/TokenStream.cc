@@ -334,6 +334,7 @@ namespace archetype {
             } // switch
         } // while - primary state machine loop
 
+        position_ = source_->position();
         return next_ch != '\0';
     }
 
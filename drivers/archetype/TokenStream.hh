@@ -19,6 +19,7 @@ namespace archetype {
     class TokenStream {
         SourceFilePtr source_;
         Token token_;
+        SourcePosition position_;
         std::list<bool> newlineIsToken_;
         bool consumed_;
         bool keepLooking_;
@@ -31,6 +32,8 @@ namespace archetype {
         void restoreNewlineSignificance() { newlineIsToken_.pop_front(); }
 
         Token token() const { return token_; }
+        // Where the current token was found.
+        SourcePosition position() const { return position_; }
         void didNotConsume();
         void expectGeneral(std::string expected);
         void expected(Token required);
@@ -0,0 +1,151 @@
+//
+//  Trace.cc
+//  archetype
+//
+//
+
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+#include "Trace.hh"
+#include "Universe.hh"
+
+using namespace std;
+
+namespace archetype {
+    bool Trace::Enabled = false;
+
+    Trace* Trace::instance_ = nullptr;
+
+    Trace& Trace::instance() {
+        if (not instance_) {
+            instance_ = new Trace;
+        }
+        return *instance_;
+    }
+
+    void Trace::destroy() {
+        delete instance_;
+        instance_ = nullptr;
+        Enabled = false;
+    }
+
+    Trace::Trace():
+    next_{0}
+    { }
+
+    Trace::~Trace() {
+    }
+
+    void Trace::enable(size_t capacity) {
+        if ((capacity & (capacity - 1)) != 0 or capacity == 0) {
+            throw invalid_argument("Trace capacity must be a power of two");
+        }
+        if (ring_.size() != capacity) {
+            ring_.assign(capacity, Record{0, 0, 0, 0});
+            next_ = 0;
+            start_ = chrono::steady_clock::now();
+        }
+        Enabled = true;
+    }
+
+    void Trace::disable() {
+        Enabled = false;
+    }
+
+    void Trace::record(Event_e event, int object, int argument) {
+        Record& r = ring_[next_++ & (ring_.size() - 1)];
+        r.nanoseconds = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start_).count();
+        r.object = object;
+        r.argument = argument;
+        r.event = event;
+    }
+
+    size_t Trace::size() const {
+        return next_ < ring_.size() ? static_cast<size_t>(next_) : ring_.size();
+    }
+
+    vector<Trace::Record> Trace::records() const {
+        vector<Record> result;
+        uint64_t first = next_ - size();
+        for (uint64_t i = first; i < next_; ++i) {
+            result.push_back(ring_[i & (ring_.size() - 1)]);
+        }
+        return result;
+    }
+
+    static void display_object(ostream& out, int object_id) {
+        if (Universe::instance().getObject(object_id)) {
+            ObjectValue{object_id}.display(out);
+        } else {
+            out << "<object " << object_id << ">";
+        }
+    }
+
+    template <class Index>
+    static void display_name(ostream& out, const Index& index, int id, const char* quote) {
+        if (id >= 0 and index.hasIndex(id)) {
+            out << quote << index.get(id) << quote;
+        } else {
+            out << id;
+        }
+    }
+
+    void Trace::dump(ostream& out) const {
+        static const char* EventNames[] = {
+            "dispatch", "send", "pass", "read", "write", "create", "destroy"
+        };
+        Universe& u = Universe::instance();
+        uint64_t sequence = next_ - size();
+        out << "Trace of the last " << size() << " of " << next_ << " events" << endl;
+        for (auto const& r : records()) {
+            out << setw(10) << sequence++ << ' '
+                << setw(14) << fixed << setprecision(3) << r.nanoseconds / 1000.0 << "us "
+                << setw(9) << left << EventNames[r.event] << right << ' ';
+            // The objects and names may be long gone; dumping must not fail.
+            try {
+                display_object(out, r.object);
+                switch (r.event) {
+                    case DISPATCH:
+                        out << ' ';
+                        display_name(out, u.Messages, r.argument, "'");
+                        break;
+                    case SEND:
+                    case PASS:
+                        out << " from ";
+                        display_object(out, r.argument);
+                        break;
+                    case READ_ATTRIBUTE:
+                    case WRITE_ATTRIBUTE:
+                        out << '.';
+                        display_name(out, u.Identifiers, r.argument, "");
+                        break;
+                    case CREATE:
+                        out << " based on ";
+                        display_object(out, r.argument);
+                        break;
+                    default:
+                        break;
+                }
+            } catch (const std::exception&) {
+                out << " (" << r.object << ", " << r.argument << ")";
+            }
+            out << endl;
+        }
+    }
+
+    void Trace::dump() const {
+        if (dumpPath_.empty()) {
+            dump(cerr);
+        } else {
+            ofstream out(dumpPath_.c_str());
+            if (out) {
+                dump(out);
+            } else {
+                cerr << "Cannot write trace to " << dumpPath_ << endl;
+            }
+        }
+    }
+
+}
@@ -0,0 +1,94 @@
+//
+//  Trace.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__Trace__
+#define __archetype__Trace__
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(__GNUC__) || defined(__clang__)
+#  define ARCHETYPE_UNLIKELY(cond) __builtin_expect(static_cast<bool>(cond), 0)
+#else
+#  define ARCHETYPE_UNLIKELY(cond) (cond)
+#endif
+
+// Records an event if tracing is on.  When it is off, this is one test of a
+// global flag that is almost never taken, and nothing else.
+#define ARCHETYPE_TRACE(...) \
+do { if (ARCHETYPE_UNLIKELY(archetype::Trace::Enabled)) archetype::Trace::instance().record(__VA_ARGS__); } while (0)
+
+namespace archetype {
+
+    // A ring buffer of the most recent interpreter events, each a fixed-size
+    // binary record.  Unlike the DEBUG system messages, nothing is formatted or
+    // written until the trace is dumped, which happens on request with
+    // 'DUMP TRACE' -> system, when a dispatch to the Universe fails, and at exit.
+    class Trace {
+    public:
+        enum Event_e {
+            DISPATCH,           // object, message (-1 if not a message)
+            SEND,               // object, sender
+            PASS,               // object, sender
+            READ_ATTRIBUTE,     // object, attribute
+            WRITE_ATTRIBUTE,    // object, attribute
+            CREATE,             // object, parent
+            DESTROY             // object
+        };
+
+        struct Record {
+            std::int64_t nanoseconds;   // since tracing was enabled
+            std::int32_t object;
+            std::int32_t argument;
+            std::int32_t event;
+        };
+
+        // Must be a power of two.
+        static const std::size_t DefaultCapacity = 1 << 16;
+
+        static bool Enabled;
+
+        static Trace& instance();
+        static void destroy();
+
+        // Where dumps go.  Empty, the default, means the error stream.
+        std::string dumpPath() const { return dumpPath_; }
+        void setDumpPath(std::string path) { dumpPath_ = path; }
+
+        void enable(std::size_t capacity = DefaultCapacity);
+        void disable();
+
+        void record(Event_e event, int object, int argument = -1);
+
+        // Number of records held, at most the capacity.
+        std::size_t size() const;
+        std::vector<Record> records() const;
+
+        // Write out the records held, oldest first, with names looked up in the Universe.
+        void dump(std::ostream& out) const;
+        // Dump to the dump path, or the error stream.
+        void dump() const;
+
+    private:
+        std::vector<Record> ring_;
+        std::uint64_t next_;
+        std::chrono::steady_clock::time_point start_;
+        std::string dumpPath_;
+
+        static Trace* instance_;
+
+        Trace();
+        Trace(const Trace&) = delete;
+        Trace& operator=(const Trace&) = delete;
+        ~Trace();
+    };
+
+}
+
+#endif /* defined(__archetype__Trace__) */
@@ -0,0 +1,88 @@
+//
+//  TurnLimits.cc
+//  archetype
+//
+//
+
+#include <algorithm>
+
+#include "TurnLimits.hh"
+
+using namespace std;
+
+namespace archetype {
+    bool TurnLimits::Enabled = false;
+
+    TurnLimits* TurnLimits::instance_ = nullptr;
+
+    TurnLimits& TurnLimits::instance() {
+        if (not instance_) {
+            instance_ = new TurnLimits;
+        }
+        return *instance_;
+    }
+
+    void TurnLimits::destroy() {
+        delete instance_;
+        instance_ = nullptr;
+        Enabled = false;
+    }
+
+    TurnLimits::TurnLimits():
+    maxStatements_{0},
+    maxSendDepth_{0},
+    maxMilliseconds_{0},
+    statements_{0},
+    nextCheck_{0},
+    sendDepth_{0},
+    start_{Clock::now()}
+    { }
+
+    TurnLimits::~TurnLimits() {
+    }
+
+    void TurnLimits::setMaxStatements(long long limit) {
+        maxStatements_ = max(limit, 0LL);
+        update_();
+    }
+
+    void TurnLimits::setMaxSendDepth(int limit) {
+        maxSendDepth_ = max(limit, 0);
+        update_();
+    }
+
+    void TurnLimits::setMaxMilliseconds(int limit) {
+        maxMilliseconds_ = max(limit, 0);
+        update_();
+    }
+
+    void TurnLimits::update_() {
+        Enabled = maxStatements_ > 0 or maxSendDepth_ > 0 or maxMilliseconds_ > 0;
+        beginTurn();
+    }
+
+    void TurnLimits::beginTurn() {
+        statements_ = 0;
+        start_ = Clock::now();
+        nextCheck_ = 0;
+        check_();
+    }
+
+    void TurnLimits::check_() {
+        if (maxStatements_ > 0 and statements_ > maxStatements_) {
+            exceeded_("more than " + to_string(maxStatements_) + " statements executed");
+        }
+        if (maxMilliseconds_ > 0 and Clock::now() - start_ > chrono::milliseconds(maxMilliseconds_)) {
+            exceeded_("ran longer than " + to_string(maxMilliseconds_) + " ms");
+        }
+        nextCheck_ = statements_ + ClockInterval;
+        if (maxStatements_ > 0) {
+            nextCheck_ = min(nextCheck_, maxStatements_ + 1);
+        }
+    }
+
+    void TurnLimits::exceeded_(string what) const {
+        throw TurnLimitExceeded("Turn abandoned: " + what);
+    }
+
+}
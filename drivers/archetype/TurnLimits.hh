@@ -0,0 +1,113 @@
+//
+//  TurnLimits.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__TurnLimits__
+#define __archetype__TurnLimits__
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+namespace archetype {
+
+    // Thrown when a turn runs past one of its limits.  The turn cannot be finished,
+    // so whatever it changed must be thrown away.
+    class TurnLimitExceeded : public std::runtime_error {
+    public:
+        TurnLimitExceeded(std::string what): std::runtime_error(what) { }
+    };
+
+    // Limits on the work a single dispatch to the Universe may do: the number of
+    // statements executed, how deeply sends and passes may nest, and how long it
+    // may run.  A limit of zero is no limit.  These are meant for --update, where
+    // one dispatch is one turn and a game that never returns holds on to a server.
+    class TurnLimits {
+    public:
+        // Set whenever any limit is; checked before anything else is done.
+        static bool Enabled;
+
+        // The send depth allowed in --update unless told otherwise.
+        static const int DefaultMaxSendDepth = 1000;
+
+        static TurnLimits& instance();
+        static void destroy();
+
+        long long maxStatements() const { return maxStatements_; }
+        void setMaxStatements(long long limit);
+        int maxSendDepth() const { return maxSendDepth_; }
+        void setMaxSendDepth(int limit);
+        int maxMilliseconds() const { return maxMilliseconds_; }
+        void setMaxMilliseconds(int limit);
+
+        // Start counting afresh.
+        void beginTurn();
+
+        long long statements() const { return statements_; }
+        int sendDepth() const { return sendDepth_; }
+
+        void statement() {
+            if (++statements_ >= nextCheck_) {
+                check_();
+            }
+        }
+        void enterSend() {
+            if (sendDepth_ >= maxSendDepth_ and maxSendDepth_ > 0) {
+                exceeded_("sends nested more than " + std::to_string(maxSendDepth_) + " deep");
+            }
+            ++sendDepth_;
+        }
+        void exitSend() {
+            --sendDepth_;
+        }
+
+    private:
+        // Statements between looks at the clock.
+        static const long long ClockInterval = 1024;
+
+        typedef std::chrono::steady_clock Clock;
+
+        long long maxStatements_;
+        int maxSendDepth_;
+        int maxMilliseconds_;
+        long long statements_;
+        long long nextCheck_;
+        int sendDepth_;
+        Clock::time_point start_;
+
+        static TurnLimits* instance_;
+
+        TurnLimits();
+        TurnLimits(const TurnLimits&) = delete;
+        TurnLimits& operator=(const TurnLimits&) = delete;
+        ~TurnLimits();
+
+        void update_();
+        void check_();
+        void exceeded_(std::string what) const;
+    };
+
+    // Counts its own lifetime as one level of sending, if there are limits.  Tail
+    // sends delivered in the same frame use no more native stack, so are not counted.
+    class SendDepthScope {
+        bool active_;
+    public:
+        SendDepthScope(): active_{TurnLimits::Enabled} {
+            if (active_) {
+                TurnLimits::instance().enterSend();
+            }
+        }
+        ~SendDepthScope() {
+            if (active_) {
+                TurnLimits::instance().exitSend();
+            }
+        }
+        SendDepthScope(const SendDepthScope&) = delete;
+        SendDepthScope& operator=(const SendDepthScope&) = delete;
+    };
+
+}
+
+#endif /* defined(__archetype__TurnLimits__) */
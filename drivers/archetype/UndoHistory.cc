@@ -0,0 +1,158 @@
+//
+//  UndoHistory.cc
+//  archetype
+//
+//
+
+#include <stdexcept>
+
+#include "UndoHistory.hh"
+#include "ComputedAttributes.hh"
+#include "Universe.hh"
+
+using namespace std;
+
+namespace archetype {
+    bool UndoHistory::Recording = false;
+    bool UndoHistory::EveryTurn = false;
+
+    UndoHistory::UndoHistory():
+    capacity_{DefaultCapacity},
+    forgotten_{0},
+    turnBegun_{false}
+    { }
+
+    UndoHistory::~UndoHistory() {
+        Recording = false;
+    }
+
+    void UndoHistory::setCapacity(int capacity) {
+        if (capacity < 1) {
+            throw invalid_argument("Need room for at least one snapshot");
+        }
+        capacity_ = capacity;
+        while (snapshots() > capacity_) {
+            forgetOldest_();
+        }
+    }
+
+    void UndoHistory::takeSnapshot() {
+        if (snapshots() == capacity_) {
+            forgetOldest_();
+        }
+        Universe& u = Universe::instance();
+        MemoryStorage system;
+        u.getObject(Universe::SystemObjectId)->write(system);
+        snapshots_.push_back(Snapshot{forgotten_ + static_cast<long long>(log_.size()), u.ended(), {}});
+        snapshots_.back().system.swap(system.bytes());
+        turnBegun_ = false;
+        Recording = true;
+    }
+
+    void UndoHistory::beginTurn() {
+        takeSnapshot();
+        turnBegun_ = true;
+    }
+
+    bool UndoHistory::undo() {
+        if (snapshots() < (turnBegun_ ? 2 : 1)) {
+            return false;
+        }
+        // Putting things back must not itself be recorded.
+        Recording = false;
+        if (turnBegun_) {
+            restore_(snapshots_.back());
+            snapshots_.pop_back();
+            turnBegun_ = false;
+        }
+        restore_(snapshots_.back());
+        snapshots_.pop_back();
+        Recording = not snapshots_.empty();
+        return true;
+    }
+
+    void UndoHistory::clear() {
+        snapshots_.clear();
+        log_.clear();
+        forgotten_ = 0;
+        turnBegun_ = false;
+        Recording = false;
+    }
+
+    void UndoHistory::attributeChanged(int object_id, int attribute_id, Expression previous, bool was_unset) {
+        log_.push_back(Change{ATTRIBUTE_CHANGED, object_id, attribute_id, std::move(previous), was_unset, nullptr});
+    }
+
+    void UndoHistory::unsetMarked(int object_id, int attribute_id) {
+        log_.push_back(Change{UNSET_MARKED, object_id, attribute_id, nullptr, false, nullptr});
+    }
+
+    void UndoHistory::objectCreated(int object_id) {
+        log_.push_back(Change{OBJECT_CREATED, object_id, 0, nullptr, false, nullptr});
+    }
+
+    void UndoHistory::objectDestroyed(ObjectPtr object, int object_id) {
+        log_.push_back(Change{OBJECT_DESTROYED, object_id, 0, nullptr, false, std::move(object)});
+    }
+
+    void UndoHistory::revert_(Change& change) {
+        Universe& u = Universe::instance();
+        switch (change.kind) {
+            case ATTRIBUTE_CHANGED: {
+                ObjectPtr object = u.getObject(change.objectId);
+                if (not object) {
+                    break;
+                } else if (not change.previous) {
+                    object->attributes_.erase(change.attributeId);
+                } else {
+                    object->attributes_[change.attributeId] = std::move(change.previous);
+                }
+                if (change.wasUnset) {
+                    object->unset_.insert(change.attributeId);
+                }
+                ComputedAttributes::instance().attributeWritten(change.attributeId);
+                break;
+            }
+            case UNSET_MARKED: {
+                ObjectPtr object = u.getObject(change.objectId);
+                if (object) {
+                    object->unset_.erase(change.attributeId);
+                    ComputedAttributes::instance().attributeWritten(change.attributeId);
+                }
+                break;
+            }
+            case OBJECT_CREATED:
+                u.destroyObject(change.objectId);
+                break;
+            case OBJECT_DESTROYED:
+                change.object->setId(change.objectId);
+                u.objects_.restore(change.objectId, change.object);
+                ComputedAttributes::instance().objectsChanged();
+                break;
+        }
+    }
+
+    void UndoHistory::restore_(Snapshot& snapshot) {
+        while (forgotten_ + static_cast<long long>(log_.size()) > snapshot.changes) {
+            revert_(log_.back());
+            log_.pop_back();
+        }
+        Universe& u = Universe::instance();
+        u.ended_ = snapshot.ended;
+        MemoryStorage system;
+        system.bytes().swap(snapshot.system);
+        u.getObject(Universe::SystemObjectId)->read(system);
+    }
+
+    void UndoHistory::forgetOldest_() {
+        snapshots_.pop_front();
+        long long keep_from = snapshots_.empty() ?
+            forgotten_ + static_cast<long long>(log_.size()) : snapshots_.front().changes;
+        while (forgotten_ < keep_from) {
+            log_.pop_front();
+            forgotten_++;
+        }
+        Recording = not snapshots_.empty();
+    }
+
+}
@@ -0,0 +1,101 @@
+//
+//  UndoHistory.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__UndoHistory__
+#define __archetype__UndoHistory__
+
+#include <deque>
+#include <vector>
+
+#include "Expression.hh"
+#include "Serialization.hh"
+
+namespace archetype {
+
+    class Object;
+    typedef std::shared_ptr<Object> ObjectPtr;
+
+    // In-memory snapshots of the Universe, for undoing turns.  Rather than copying
+    // anything when a snapshot is taken, every change made afterwards keeps what it
+    // replaced: the old expression of an attribute, or the object destroyed.  Undoing
+    // puts those back, newest first, so costs only as much as has changed since.
+    // Snapshots are kept in a ring; once it is full, taking another forgets the oldest.
+    // The history is only ever held in memory, and is not saved with the Universe.
+    class UndoHistory {
+    public:
+        // Set whenever a snapshot is held, which is the only time changes are kept.
+        static bool Recording;
+        // Whether every 'UPDATE' sent to main begins with a snapshot, for runs that
+        // play many turns in one process.  Otherwise a game takes its own snapshots.
+        static bool EveryTurn;
+
+        static const int DefaultCapacity = 16;
+
+        UndoHistory();
+        ~UndoHistory();
+        UndoHistory(const UndoHistory&) = delete;
+        UndoHistory& operator=(const UndoHistory&) = delete;
+
+        int capacity() const { return capacity_; }
+        void setCapacity(int capacity);
+        int snapshots() const { return static_cast<int>(snapshots_.size()); }
+
+        void takeSnapshot();
+        // Snapshot at the start of a turn.  Undoing during that turn goes back past
+        // it to the start of the turn before, since undoing only the turn under way
+        // would undo nothing the player has seen.
+        void beginTurn();
+        // Return the Universe to the most recent snapshot, which is then forgotten.
+        // False if there is none.
+        bool undo();
+        void clear();
+
+        // was_unset: whether the attribute had only been read while unset before.
+        void attributeChanged(int object_id, int attribute_id, Expression previous, bool was_unset = false);
+        void unsetMarked(int object_id, int attribute_id);
+        void objectCreated(int object_id);
+        void objectDestroyed(ObjectPtr object, int object_id);
+
+    private:
+        enum Change_e {
+            ATTRIBUTE_CHANGED,
+            UNSET_MARKED,
+            OBJECT_CREATED,
+            OBJECT_DESTROYED
+        };
+
+        struct Change {
+            Change_e kind;
+            int objectId;
+            int attributeId;
+            Expression previous;
+            bool wasUnset;
+            ObjectPtr object;
+        };
+
+        struct Snapshot {
+            // Position in the log, counting every change ever logged.
+            long long changes;
+            bool ended;
+            // The system object is small and not made of attributes, so is copied.
+            std::vector<Storage::Byte> system;
+        };
+
+        int capacity_;
+        std::deque<Snapshot> snapshots_;
+        std::deque<Change> log_;
+        long long forgotten_;
+        // Whether the newest snapshot is the one taken at the start of this turn.
+        bool turnBegun_;
+
+        void revert_(Change& change);
+        void restore_(Snapshot& snapshot);
+        void forgetOldest_();
+    };
+
+}
+
+#endif /* defined(__archetype__UndoHistory__) */
@@ -11,15 +11,20 @@
 #include <sstream>
 #include <cassert>
 #include <limits>
+#include <stdexcept>
+#include <string>
 
 using namespace std;
 
 #include "Universe.hh"
+#include "ComputedAttributes.hh"
 #include "Wellspring.hh"
 #include "SystemObject.hh"
 #include "ConsoleInput.hh"
 #include "ConsoleOutput.hh"
 #include "PagedOutput.hh"
+#include "ModuleCache.hh"
+#include "Trace.hh"
 
 namespace archetype {
     Universe* Universe::instance_ = nullptr;
@@ -79,6 +84,8 @@ namespace archetype {
 
     Universe::Universe() :
     ended_(false),
+    collectsGarbage_(false),
+    readingVersion_(FormatVersion),
     input_{new ConsoleInput},
     output_{new PagedOutput{UserOutput{new ConsoleOutput}}}
     {
@@ -107,6 +114,9 @@ namespace archetype {
             case KEYWORD_ID:
                 out << "a keyword";
                 break;
+            case AMBIGUOUS_ID:
+                out << "more than one kind of thing";
+                break;
             case UNKNOWN_ID:
                 out << "an unknown identifier";
                 break;
@@ -129,6 +139,20 @@ namespace archetype {
             out << "Identifier '" << Identifiers.get(identifier);
             out << "' is already the name of " << existing_p->second << " but is used here as " << kind;
             t.errorMessage(out.str());
+            existing_p->second = AMBIGUOUS_ID;
+        }
+    }
+
+    IdentifierKind_e Universe::identifierKind(int identifier) const {
+        auto kind_p = kinds_.find(identifier);
+        return kind_p == kinds_.end() ? UNKNOWN_ID : kind_p->second;
+    }
+
+    void Universe::bindIdentifiers() {
+        for (int id = 0; id < objects_.count(); ++id) {
+            if (ObjectPtr obj = getObject(id)) {
+                obj->bindIdentifiers();
+            }
         }
     }
 
@@ -182,14 +206,25 @@ namespace archetype {
         ObjectPtr obj{make_shared<Object>(parent_id)};
         int object_id = objects_.index(obj);
         obj->setId(object_id);
+        ARCHETYPE_TRACE(Trace::CREATE, object_id, parent_id);
+        // The new object may take the id of one destroyed earlier.
+        ComputedAttributes::instance().objectsChanged();
+        if (UndoHistory::Recording) {
+            History.objectCreated(object_id);
+        }
         return objects_.get(object_id);
     }
 
     void Universe::destroyObject(int object_id) {
+        ARCHETYPE_TRACE(Trace::DESTROY, object_id);
         ObjectPtr existing = objects_.get(object_id);
+        if (UndoHistory::Recording) {
+            History.objectDestroyed(existing, object_id);
+        }
         // Debugging sentinel, noting that the object is now invalid.
         existing->setId(Object::INVALID);
         objects_.remove(object_id);
+        ComputedAttributes::instance().objectsChanged();
     }
 
     void Universe::assignObjectIdentifier(const ObjectPtr& object, std::string identifier) {
@@ -337,16 +372,23 @@ namespace archetype {
                         }
                         string source_file = TextLiterals.get(t.token().number());
                         if (Wellspring::instance().hasNeverBeenOpened(source_file)) {
+                            ModuleCache& cache = ModuleCache::instance();
+                            if (cache.link(source_file)) {
+                                break;
+                            }
                             SourceFilePtr source = Wellspring::instance().open(source_file);
                             if (not source) {
+                                cache.abandoned();
                                 t.errorMessage("Cannot open source file \"" + source_file + "\"");
                                 return false;
                             }
                             TokenStream included_tokens(source);
                             if (not make(included_tokens)) {
+                                cache.abandoned();
                                 return false;
                             }
                             Wellspring::instance().close(source);
+                            cache.compiled();
                         }
                         break;
                     }
@@ -405,25 +447,78 @@ namespace archetype {
         return in;
     }
 
+    Storage& operator<<(Storage& out, const IdentifierKindMap& m) {
+        int entries = static_cast<int>(m.size());
+        out << entries;
+        for (auto const& p : m) {
+            out << p.first << static_cast<int>(p.second);
+        }
+        return out;
+    }
+
+    Storage& operator>>(Storage&in, IdentifierKindMap& m) {
+        m.clear();
+        int entries;
+        in >> entries;
+        for (int i = 0; i < entries; ++i) {
+            int identifier, kind;
+            in >> identifier >> kind;
+            m[identifier] = static_cast<IdentifierKind_e>(kind);
+        }
+        return in;
+    }
+
+    // Unversioned Universes began with whether the game had ended, 0 or 1, so
+    // anything else there marks a version number to follow.
+    static const int VersionMarker = -1;
+
     Storage& operator<<(Storage& out, const Universe& u) {
+        out << VersionMarker << Universe::FormatVersion;
         out << static_cast<int>(u.ended_);
         out << u.Messages << u.TextLiterals << u.Identifiers << u.ObjectIdentifiers;
+        // What each identifier names is written ahead of the objects, so that their
+        // identifiers can be bound as they are read.
+        out << u.kinds_;
         out << u.objects_;
         return out;
     }
 
     Storage& operator>>(Storage& in, Universe& u) {
+        int version = 1;
         int ended;
         in >> ended;
+        if (ended == VersionMarker) {
+            in >> version >> ended;
+            if (version < 2 or version > Universe::FormatVersion) {
+                throw runtime_error("Cannot read a Universe saved in version " + to_string(version));
+            }
+        }
+        // Nothing that came before can be undone once everything is replaced.
+        u.History.clear();
         u.ended_ = static_cast<bool>(ended);
         u.Messages.clear();
         u.TextLiterals.clear();
         u.Identifiers.clear();
         u.ObjectIdentifiers.clear();
         in >> u.Messages >> u.TextLiterals >> u.Identifiers >> u.ObjectIdentifiers;
+        // Without knowing what they name, identifiers are left to be looked up as
+        // they are evaluated, as they always were.
+        if (version >= 2) {
+            in >> u.kinds_;
+        } else {
+            u.kinds_.clear();
+        }
         u.objects_.clear();
         u.createReservedObjects_();
-        in >> u.objects_;
+        u.readingVersion_ = version;
+        try {
+            in >> u.objects_;
+        } catch (...) {
+            u.readingVersion_ = Universe::FormatVersion;
+            throw;
+        }
+        u.readingVersion_ = Universe::FormatVersion;
+        ComputedAttributes::instance().objectsChanged();
         return in;
     }
 
@@ -24,6 +24,7 @@
 #include "Serialization.hh"
 #include "UserInput.hh"
 #include "UserOutput.hh"
+#include "UndoHistory.hh"
 
 namespace archetype {
 
@@ -32,7 +33,9 @@ namespace archetype {
         OBJECT_ID,
         DEFINED_ATTRIBUTE_ID,
         REFERENCED_ATTRIBUTE_ID,
-        KEYWORD_ID
+        KEYWORD_ID,
+        // Used as more than one of the above, which only evaluation can tell apart.
+        AMBIGUOUS_ID
     };
 
     class QuitGame : public std::runtime_error {
@@ -51,6 +54,12 @@ namespace archetype {
         static const int SystemObjectId = 1;
         static const int UserObjectsBeginAt = 2;
 
+        // The layout Universes are saved in.  Those saved before there were versions
+        // are version 1, and are still read.
+        //   2: what each identifier names, ahead of the objects, and the attributes
+        //      of each object only ever read while unset
+        static const int FormatVersion = 2;
+
         struct Context {
             ObjectPtr selfObject;
             ObjectPtr senderObject;
@@ -69,9 +78,19 @@ namespace archetype {
 
         IdentifierMap ObjectIdentifiers;
 
+        UndoHistory History;
+
+        // While a Universe is being read, the version it was saved in.
+        int readingVersion() const { return readingVersion_; }
+
         void endItAll() { ended_ = true; }
         bool ended() const { return ended_; }
 
+        // Whether a Universe about to be saved between turns, or for 'SAVE STATE',
+        // is first rid of the instances it can no longer reach; see collect_universe.
+        bool collectsGarbage() const { return collectsGarbage_; }
+        void setCollectsGarbage(bool collects) { collectsGarbage_ = collects; }
+
         Context& currentContext() { return context_.top(); }
         void pushContext(const Context& context) { context_.push(context); }
         void popContext() { context_.pop(); }
@@ -83,6 +102,10 @@ namespace archetype {
 
         void classify(TokenStream& t, int identifier, IdentifierKind_e kind);
         void reportUndefinedIdentifiers() const;
+        IdentifierKind_e identifierKind(int identifier) const;
+        // Bind every identifier in every object now that the whole program has
+        // been compiled; a Universe loaded from storage is bound as it is read.
+        void bindIdentifiers();
 
         int objectCount() const;
         ObjectPtr getObject(int object_id) const;
@@ -105,6 +128,8 @@ namespace archetype {
 
     private:
         bool ended_;
+        bool collectsGarbage_;
+        int readingVersion_;
         ObjectIndex objects_;
         ObjectPtr   nullObject_;
         ObjectPtr   systemObject_;
@@ -123,6 +148,8 @@ namespace archetype {
 
         void createReservedObjects_();
 
+        friend class UndoHistory;
+        friend int collect_universe();
         friend Storage& operator<<(Storage& out, const Universe& u);
         friend Storage& operator>>(Storage& in, Universe& u);
     };
@@ -141,6 +168,9 @@ namespace archetype {
     Storage& operator<<(Storage& out, const IdentifierMap& m);
     Storage& operator>>(Storage&in, IdentifierMap& m);
 
+    Storage& operator<<(Storage& out, const IdentifierKindMap& m);
+    Storage& operator>>(Storage&in, IdentifierKindMap& m);
+
     Storage& operator<<(Storage& out, const Universe& u);
     Storage& operator>>(Storage& in, Universe& u);
 
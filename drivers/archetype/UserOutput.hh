@@ -24,6 +24,10 @@ namespace archetype {
         virtual void endLine() = 0;
         virtual void resetPager() { }
         virtual void banner(char ch) = 0;
+
+        // Outputs may hold text back until this is called.  It is called at the
+        // end of every dispatch to the Universe and before every read of input.
+        virtual void flush() { }
     };
     typedef std::shared_ptr<IUserOutput> UserOutput;
 }
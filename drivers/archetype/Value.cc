@@ -13,6 +13,8 @@
 
 #include "Value.hh"
 #include "Universe.hh"
+#include "ComputedAttributes.hh"
+#include "Trace.hh"
 
 using namespace std;
 
@@ -177,21 +179,28 @@ namespace archetype {
         out << MESSAGE << message_;
     }
 
-    string TextLiteralValue::getString() const {
+    const string& TextLiteralValue::getString() const {
         return Universe::instance().TextLiterals.get(textLiteral_);
     }
 
-    Value TextLiteralValue::messageConversion() const {
-        string value = getString();
-        if (Universe::instance().Messages.has(value)) {
-            return Value{new MessageValue{Universe::instance().Messages.index(value)}};
-        } else {
+    // A message id never changes once given out, so a string value need only find
+    // the message it names once; every send after that starts from the id.  A string
+    // that names no message yet is looked up again, since the message may appear.
+    static Value find_message(const string& name, Value& message) {
+        int message_id = Universe::instance().Messages.find(name);
+        if (message_id == StringIdIndex::npos) {
             return Value{new UndefinedValue};
         }
+        message = Value{new MessageValue{message_id}};
+        return message->clone();
+    }
+
+    Value TextLiteralValue::messageConversion() const {
+        return message_ ? message_->clone() : find_message(getString(), message_);
     }
 
     Value TextLiteralValue::stringConversion() const {
-        return Value{new StringValue{getString()}};
+        return clone();
     }
 
     Value TextLiteralValue::numericConversion() const {
@@ -199,8 +208,13 @@ namespace archetype {
     }
 
     bool TextLiteralValue::isSameValueAs(const Value &other) const {
-        const TextLiteralValue* other_p = dynamic_cast<const TextLiteralValue*>(other.get());
-        return other_p and other_p->textLiteral_ == textLiteral_;
+        if (const TextLiteralValue* other_p = dynamic_cast<const TextLiteralValue*>(other.get())) {
+            return other_p->textLiteral_ == textLiteral_;
+        }
+        // A literal is its own string conversion, so it must match the same text
+        // held as a string.
+        const StringValue* other_p = dynamic_cast<const StringValue*>(other.get());
+        return other_p and other_p->getString() == getString();
     }
 
     void TextLiteralValue::display(std::ostream &out) const {
@@ -235,8 +249,11 @@ namespace archetype {
     }
 
     bool StringValue::isSameValueAs(const Value &other) const {
-        const StringValue* other_p = dynamic_cast<const StringValue*>(other.get());
-        return other_p and other_p->value_ == value_;
+        if (const StringValue* other_p = dynamic_cast<const StringValue*>(other.get())) {
+            return other_p->value_ == value_;
+        }
+        const TextLiteralValue* other_p = dynamic_cast<const TextLiteralValue*>(other.get());
+        return other_p and other_p->getString() == value_;
     }
 
     void StringValue::display(std::ostream &out) const {
@@ -251,16 +268,12 @@ namespace archetype {
         out.write(buffer, text_length);
     }
 
-    string StringValue::getString() const {
+    const string& StringValue::getString() const {
         return value_;
     }
 
     Value StringValue::messageConversion() const {
-        if (Universe::instance().Messages.has(value_)) {
-            return Value{new MessageValue{Universe::instance().Messages.index(value_)}};
-        } else {
-            return Value{new UndefinedValue};
-        }
+        return message_ ? message_->clone() : find_message(value_, message_);
     }
 
     Value StringValue::numericConversion() const {
@@ -353,14 +366,23 @@ namespace archetype {
         if (not obj) {
             return Value{new UndefinedValue};
         }
+        ARCHETYPE_TRACE(Trace::READ_ATTRIBUTE, objectId_, attributeId_);
 
-        if (not obj->hasAttribute(attributeId_)) {
-            obj->setAttribute(attributeId_, Value{new UndefinedValue});
+        const IExpression* attribute = obj->findAttribute(attributeId_);
+        if (not attribute) {
+            obj->markUnset(attributeId_);
         }
-
-        ContextScope c;
-        c->selfObject = obj;
-        return obj->getAttributeValue(attributeId_);
+        // Noted even when unset, since assigning it later changes what was read, but
+        // only once marked, so that the mark itself is not taken for a later write.
+        ComputedAttributes::instance().attributeRead(attributeId_);
+        if (not attribute) {
+            return Value{new UndefinedValue};
+        }
+        // Most attributes simply hold a value, which needs no context to evaluate.
+        if (auto value_expr = dynamic_cast<const ValueExpression*>(attribute)) {
+            return value_expr->evaluate();
+        }
+        return ComputedAttributes::instance().evaluate(obj, attributeId_, *attribute);
     }
 
     bool AttributeValue::isTrueEnough() const {
@@ -392,19 +414,45 @@ namespace archetype {
         if (not obj) {
             return Value{new UndefinedValue};
         } else {
+            ARCHETYPE_TRACE(Trace::WRITE_ATTRIBUTE, objectId_, attributeId_);
             obj->setAttribute(attributeId_, Expression{new ValueExpression{std::move(new_value)}});
             return clone();
         }
     }
 
-    bool PairValue::isSameValueAs(const Value &other) const {
-        if (const PairValue* other_p = dynamic_cast<const PairValue*>(other.get())) {
-            return head_->isSameValueAs(other_p->head_) and tail_->isSameValueAs(other_p->tail_);
+    bool AttributeValue::appendInPlace(const string& text) {
+        ObjectPtr obj = Universe::instance().getObject(objectId_);
+        if (obj and obj->appendToAttribute(attributeId_, text)) {
+            ARCHETYPE_TRACE(Trace::WRITE_ATTRIBUTE, objectId_, attributeId_);
+            return true;
         } else {
             return false;
         }
     }
 
+    bool PairValue::isSameValueAs(const Value &other) const {
+        const PairValue* this_p = this;
+        const PairValue* other_p = dynamic_cast<const PairValue*>(other.get());
+        // Walk along the tails rather than recursing into them, so long lists
+        // cannot exhaust the stack, and stop at the first tail both share.
+        while (other_p) {
+            if (this_p == other_p) {
+                return true;
+            }
+            if (not this_p->head_->isSameValueAs(other_p->head_)) {
+                return false;
+            }
+            const Value& this_tail = this_p->tail_;
+            const Value& other_tail = other_p->tail_;
+            this_p = dynamic_cast<const PairValue*>(this_tail.get());
+            other_p = dynamic_cast<const PairValue*>(other_tail.get());
+            if (not this_p) {
+                return not other_p and this_tail->isSameValueAs(other_tail);
+            }
+        }
+        return false;
+    }
+
     Value PairValue::head() const {
         return head_->clone();
     }
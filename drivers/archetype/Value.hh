@@ -9,10 +9,12 @@
 #ifndef __archetype__Value__
 #define __archetype__Value__
 
+#include <cstddef>
 #include <iostream>
 #include <string>
 #include <memory>
 #include <stdexcept>
+#include <utility>
 
 #include "Keywords.hh"
 #include "Serialization.hh"
@@ -20,13 +22,54 @@
 namespace archetype {
 
     class IValue;
-    typedef std::unique_ptr<IValue> Value;
+
+    // A counted reference to a value.  Values never change once made, so rather than
+    // each holder owning a copy, every holder shares the one value, and clone() costs
+    // a count instead of an allocation.  Like the unique_ptr it replaces, a Value is
+    // moved rather than copied; sharing is always spelled out with clone().
+    class Value {
+        IValue* value_;
+
+        void release_();
+    public:
+        Value(): value_(nullptr) { }
+        Value(std::nullptr_t): value_(nullptr) { }
+        explicit Value(IValue* value);
+        Value(Value&& other) noexcept: value_(other.value_) { other.value_ = nullptr; }
+        Value(const Value&) = delete;
+        ~Value() { release_(); }
+
+        Value& operator=(Value&& other) noexcept {
+            Value(std::move(other)).swap(*this);
+            return *this;
+        }
+        Value& operator=(const Value&) = delete;
+
+        // Whether this is the only reference, so that nobody else could see a change.
+        bool unique() const;
+
+        IValue* get() const              { return value_; }
+        IValue* operator->() const       { return value_; }
+        IValue& operator*() const        { return *value_; }
+        explicit operator bool() const   { return value_ != nullptr; }
+
+        void reset(IValue* value = nullptr);
+        void swap(Value& other) noexcept { std::swap(value_, other.value_); }
+    };
+
+    inline bool operator==(const Value& v, std::nullptr_t) { return not v; }
+    inline bool operator!=(const Value& v, std::nullptr_t) { return bool(v); }
+    inline bool operator==(std::nullptr_t, const Value& v) { return not v; }
+    inline bool operator!=(std::nullptr_t, const Value& v) { return bool(v); }
 
     std::ostream& operator<<(std::ostream& out, const Value& value);
 
     class IValue {
+        // Only ever one thread, so a plain count will do.
+        mutable int references_;
+        friend class Value;
     public:
-        IValue() { }
+        IValue(): references_(0) { }
         IValue(const IValue&) = delete;
         IValue& operator=(const IValue&) = delete;
         virtual ~IValue() { }
@@ -34,13 +77,15 @@ namespace archetype {
         virtual bool isDefined() const        { return true; }
 
         virtual bool isSameValueAs(const Value& other) const = 0;
-        virtual Value clone() const = 0;
+        // Another reference to this same value.
+        Value clone() const { return Value{const_cast<IValue*>(this)}; }
         virtual void display(std::ostream& out) const = 0;
         virtual void write(Storage& out) const = 0;
 
         virtual bool isTrueEnough() const     { return true; }
         virtual int getMessage() const        { throw std::logic_error("Value is not a defined message"); }
-        virtual std::string getString() const { throw std::logic_error("Value is not a string"); }
+        // Borrowed, not copied: good for as long as the value it came from.
+        virtual const std::string& getString() const { throw std::logic_error("Value is not a string"); }
         virtual int getNumber() const         { throw std::logic_error("Value is not a number"); }
         virtual int getObject() const         { throw std::logic_error("Value is not an object reference"); }
         virtual int getIdentifier() const     { throw std::logic_error("Value does not have an identifier"); }
@@ -57,13 +102,15 @@ namespace archetype {
         virtual Value tail() const;
 
         virtual Value assign(Value new_value);
+        // `&:=` carried out without copying what is already there, if it can be;
+        // returns whether it was.
+        virtual bool appendInPlace(const std::string&) { return false; }
     };
 
     class UndefinedValue : public IValue {
     public:
         UndefinedValue() { }
         virtual bool isSameValueAs(const Value& other) const override;
-        virtual Value clone() const override { return Value{new UndefinedValue}; }
         virtual void display(std::ostream& out) const override;
         virtual void write(Storage& out) const override;
 
@@ -75,7 +122,6 @@ namespace archetype {
     public:
         AbsentValue() { }
         virtual bool isSameValueAs(const Value& other) const override;
-        virtual Value clone() const override { return Value{new AbsentValue}; }
         virtual void display(std::ostream& out) const override;
         virtual void write(Storage& out) const override;
 
@@ -87,7 +133,6 @@ namespace archetype {
     public:
         BreakValue() { }
         virtual bool isSameValueAs(const Value& other) const override;
-        virtual Value clone() const override { return Value{new BreakValue}; }
         virtual void display(std::ostream& out) const override;
         virtual void write(Storage& out) const override;
 
@@ -100,7 +145,6 @@ namespace archetype {
         BooleanValue(bool value): value_(value) { }
 
         virtual bool isSameValueAs(const Value& other) const override;
-        virtual Value clone() const override { return Value(new BooleanValue(value_)); }
         virtual void display(std::ostream& out) const override;
         virtual void write(Storage& out) const override;
 
@@ -115,7 +159,6 @@ namespace archetype {
         MessageValue(int message): message_(message) { }
 
         virtual bool isSameValueAs(const Value& other) const override;
-        virtual Value clone() const override { return Value{new MessageValue{message_}}; }
         virtual void display(std::ostream& out) const override;
         virtual void write(Storage& out) const override;
 
@@ -127,15 +170,17 @@ namespace archetype {
 
     class TextLiteralValue : public IValue {
         int textLiteral_;
+        // The message this names, once it has been looked up.
+        mutable Value message_;
     public:
         TextLiteralValue(int text_literal): textLiteral_(text_literal) { }
+        int textLiteral() const { return textLiteral_; }
 
         virtual bool isSameValueAs(const Value& other) const override;
-        virtual Value clone() const override { return Value{new TextLiteralValue{textLiteral_}}; }
         virtual void display(std::ostream& out) const override;
         virtual void write(Storage& out) const override;
 
-        virtual std::string getString() const override;
+        virtual const std::string& getString() const override;
 
         virtual Value messageConversion() const override;
         virtual Value stringConversion() const override;
@@ -148,7 +193,6 @@ namespace archetype {
         NumericValue(int value): value_(value) { }
 
         virtual bool isSameValueAs(const Value& other) const override;
-        virtual Value clone() const override { return Value(new NumericValue(value_)); }
         virtual void display(std::ostream& out) const override;
         virtual void write(Storage& out) const override;
 
@@ -160,15 +204,22 @@ namespace archetype {
 
     class StringValue : public IValue {
         std::string value_;
+        // The message this names, once it has been looked up.
+        mutable Value message_;
     public:
-        StringValue(std::string value): value_(value) { }
+        StringValue(std::string value): value_(std::move(value)) { }
 
         virtual bool isSameValueAs(const Value& other) const override;
-        virtual Value clone() const override { return Value(new StringValue(value_)); }
         virtual void display(std::ostream& out) const override;
         virtual void write(Storage& out) const override;
 
-        virtual std::string getString() const override;
+        virtual const std::string& getString() const override;
+        // The one exception to values never changing, for a string no one else
+        // holds (see Value::unique), so that accumulating one is not quadratic.
+        void append(const std::string& text) {
+            value_ += text;
+            message_.reset();
+        }
 
         virtual Value messageConversion() const override;
         virtual Value stringConversion() const override { return clone(); }
@@ -181,7 +232,6 @@ namespace archetype {
         IdentifierValue(int id): id_(id) { }
 
         virtual bool isSameValueAs(const Value& other) const override;
-        virtual Value clone() const override { return Value(new IdentifierValue(id_)); }
         virtual void display(std::ostream& out) const override;
         virtual void write(Storage& out) const override;
 
@@ -196,7 +246,6 @@ namespace archetype {
         ObjectValue(int object_id): objectId_(object_id) { }
 
         virtual bool isSameValueAs(const Value& other) const override;
-        virtual Value clone() const override { return Value{new ObjectValue{objectId_}}; }
         virtual void display(std::ostream& out) const override;
         virtual void write(Storage& out) const override;
 
@@ -216,9 +265,9 @@ namespace archetype {
         Value dereference_() const;
     public:
         AttributeValue(int object_id, int attribute_id): objectId_(object_id), attributeId_(attribute_id) { }
+        int objectId() const { return objectId_; }
 
         virtual bool isSameValueAs(const Value& other) const override;
-        virtual Value clone() const override { return Value(new AttributeValue(objectId_, attributeId_)); }
         virtual void display(std::ostream& out) const override;
         virtual void write(Storage& out) const override;
 
@@ -233,30 +282,46 @@ namespace archetype {
         virtual Value valueConversion() const override;
 
         virtual Value assign(Value new_value) override;
+        virtual bool appendInPlace(const std::string& text) override;
     };
 
+    // Like every value, a pair never changes once made, so the tail of a list is
+    // shared by all the lists built on it.  Copying or taking apart a list therefore
+    // costs the same however long it is.
     class PairValue : public IValue {
         Value head_;
         Value tail_;
     public:
-        PairValue(Value head, Value tail):
-        head_(std::move(head)),
-        tail_(std::move(tail))
-        { }
+        PairValue(Value head, Value tail): head_(std::move(head)), tail_(std::move(tail)) { }
 
         virtual bool isSameValueAs(const Value& other) const override;
-        virtual Value clone() const override {
-            return Value{new PairValue{head_->clone(), tail_->clone()}};
-        }
-
         virtual Value head() const override;
         virtual Value tail() const override;
 
         virtual void display(std::ostream& out) const override;
         virtual void write(Storage& out) const override;
-
     };
 
+    inline Value::Value(IValue* value): value_(value) {
+        if (value_) {
+            value_->references_++;
+        }
+    }
+
+    inline bool Value::unique() const {
+        return value_ and value_->references_ == 1;
+    }
+
+    inline void Value::release_() {
+        if (value_ and --value_->references_ == 0) {
+            delete value_;
+        }
+    }
+
+    inline void Value::reset(IValue* value) {
+        Value(value).swap(*this);
+    }
+
     Storage& operator<<(Storage& out, const Value& v);
     Storage& operator>>(Storage& in, Value& v);
 
@@ -33,12 +33,7 @@ namespace archetype {
         paths_.push_back(directory_path);
     }
 
-    SourceFilePtr Wellspring::open(string source_name) {
-        auto result = sources_.find(source_name);
-        if (result != sources_.end()) {
-            everBeenOpened_.insert(source_name);
-            return result->second;
-        }
+    string Wellspring::locate(string source_name) const {
         for (auto p : paths_) {
             string try_path = p;
             assert(!try_path.empty());
@@ -49,18 +44,38 @@ namespace archetype {
             if (source_name.find('.') == string::npos) {
                 try_path += ".ach";
             }
-            unique_ptr<ifstream> input(new ifstream(try_path.c_str()));
+            ifstream input(try_path.c_str());
+            if (input.is_open()) {
+                return try_path;
+            }
+        }
+        return "";
+    }
+
+    SourceFilePtr Wellspring::open(string source_name) {
+        auto result = sources_.find(source_name);
+        if (result != sources_.end()) {
+            everBeenOpened_.insert(source_name);
+            return result->second;
+        }
+        string path = locate(source_name);
+        if (not path.empty()) {
+            unique_ptr<ifstream> input(new ifstream(path.c_str()));
             if (input->is_open()) {
                 // Now that it's been tested for openness, move it to a higher abstraction
                 stream_ptr source_stream{input.release()};
-                SourceFilePtr source{make_shared<SourceFile>(try_path, source_stream)};
-                sources_[try_path] = source;
+                SourceFilePtr source{make_shared<SourceFile>(path, source_stream)};
+                sources_[path] = source;
                 return source;
             }
         }
         return nullptr;
     }
 
+    bool Wellspring::wasPut(std::string source_name) const {
+        return sources_.count(source_name) > 0;
+    }
+
     bool Wellspring::hasNeverBeenOpened(std::string source_name) const {
         return everBeenOpened_.count(source_name) == 0;
     }
@@ -40,6 +40,13 @@ namespace archetype {
         // It will be searched after all the paths that have been added via this call so far.
         void addSearchPath(std::string directory_path);
 
+        // Returns the path at which open() would find the named source file,
+        // or an empty string if it is on none of the search paths.
+        std::string locate(std::string source_name) const;
+
+        // True if the named source was supplied through put() rather than found on disk.
+        bool wasPut(std::string source_name) const;
+
         bool hasNeverBeenOpened(std::string source_name) const;
         void put(std::string source_name, SourceFilePtr source);
         SourceFilePtr open(std::string source_name);
@@ -7,6 +7,8 @@
 //
 
 #include <string>
+#include <cctype>
+#include <algorithm>
 
 #include "WrappedOutput.hh"
 
@@ -15,6 +17,27 @@ using namespace std;
 namespace archetype {
     const int SafetyMargin = 3;
 
+    namespace {
+        // Collects whatever a WrappedOutput passes on, joining the puts within a line.
+        class RecordedOutput : public IUserOutput {
+        public:
+            TextPieces pieces;
+
+            virtual void put(const std::string& line) override {
+                if (pieces.empty() or pieces.back().endsLine) {
+                    pieces.push_back(TextPiece{line, false});
+                } else {
+                    pieces.back().text += line;
+                }
+            }
+            virtual void endLine() override {
+                put("");
+                pieces.back().endsLine = true;
+            }
+            virtual void banner(char) override { }
+        };
+    }
+
     WrappedOutput::WrappedOutput(UserOutput output, int max_columns):
     output_{output} {
         setMaxColumns(max_columns);
@@ -38,19 +61,25 @@ namespace archetype {
             cursor_ += line.size();
             return;
         }
-        string s = line;
+        // The line is never copied or shortened; begin marks the start of what
+        // has not yet been written, and each finished piece goes out through segment_.
+        const int length = static_cast<int>(line.size());
+        int begin = 0;
 
         int remaining = max(0, maxColumns_ - cursor_);
         // Keep trailing punctuation from being orphaned on the next line.
-        if (not s.empty() and ispunct(s[0])) {
+        if (length > 0 and ispunct(static_cast<unsigned char>(line[0]))) {
             remaining += SafetyMargin;
         }
 
-        while (int(s.size()) > remaining) {
-            // Walk backward to find a breaking point.
-            auto cut_p = s.begin() + remaining;
-            while (not isspace(*cut_p) and cut_p != s.begin()) {
-                --cut_p;
+        while (length - begin > remaining) {
+            // Find the last breaking point that fits, scanning forward.
+            const int limit = begin + remaining;
+            int cut = begin;
+            for (int i = begin + 1; i <= limit; ++i) {
+                if (isspace(static_cast<unsigned char>(line[i]))) {
+                    cut = i;
+                }
             }
 
             // If we were unable to find a wrapping point, it means one of two
@@ -58,21 +87,26 @@ namespace archetype {
             // split unnaturally; or b) we are near the end of a line and must wrap
             // the entire string; i.e. print nothing, finish the line and go on.
 
-            if (cut_p == s.begin() and int(s.size()) > maxColumns_) {
-                cut_p = s.begin() + remaining;
+            if (cut == begin and length - begin > maxColumns_) {
+                cut = limit;
             }
 
-            string written(s.begin(), cut_p);
-            output_->put(written);
+            segment_.assign(line, begin, cut - begin);
+            output_->put(segment_);
             endLine();
-            while (cut_p != s.end() and isspace(*cut_p)) {
-                ++cut_p;
+            while (cut != length and isspace(static_cast<unsigned char>(line[cut]))) {
+                ++cut;
             }
-            s.erase(s.begin(), cut_p);
+            begin = cut;
             remaining = maxColumns_;
         }
-        output_->put(s);
-        cursor_ += s.size();
+        if (begin == 0) {
+            output_->put(line);
+        } else {
+            segment_.assign(line, begin, string::npos);
+            output_->put(segment_);
+        }
+        cursor_ += length - begin;
     }
 
     void WrappedOutput::endLine() {
@@ -88,4 +122,31 @@ namespace archetype {
         output_->put(banner_str);
         endLine();
     }
+
+    WrappedText WrappedOutput::wrap(const TextPieces& text) const {
+        auto recorded = make_shared<RecordedOutput>();
+        WrappedOutput wrapper{recorded, maxColumns_};
+        wrapper.cursor_ = cursor_;
+        for (auto const& piece : text) {
+            wrapper.put(piece.text);
+            if (piece.endsLine) {
+                wrapper.endLine();
+            }
+        }
+        return WrappedText{std::move(recorded->pieces), wrapper.cursor_};
+    }
+
+    void WrappedOutput::putWrapped(const WrappedText& wrapped) {
+        for (auto const& piece : wrapped.pieces) {
+            output_->put(piece.text);
+            if (piece.endsLine) {
+                endLine();
+            }
+        }
+        cursor_ = wrapped.cursor;
+    }
+
+    void WrappedOutput::flush() {
+        output_->flush();
+    }
 }
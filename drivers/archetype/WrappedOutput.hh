@@ -9,12 +9,31 @@
 #ifndef __archetype__WrappedOutput__
 #define __archetype__WrappedOutput__
 
+#include <string>
+#include <vector>
+
 #include "UserOutput.hh"
 
 namespace archetype {
+    // Text as it is handed to an output:  a series of puts, each one optionally
+    // followed by an endLine.
+    struct TextPiece {
+        std::string text;
+        bool endsLine;
+    };
+    typedef std::vector<TextPiece> TextPieces;
+
+    // Text already wrapped for one width and starting cursor, along with the
+    // cursor it leaves behind.
+    struct WrappedText {
+        TextPieces pieces;
+        int cursor;
+    };
+
     class WrappedOutput : public IUserOutput {
         int maxColumns_;
         int cursor_;
+        std::string segment_;
     protected:
         UserOutput output_;
     public:
@@ -23,6 +42,7 @@ namespace archetype {
         virtual void put(const std::string& line) override;
         virtual void endLine() override;
         virtual void banner(char ch) override;
+        virtual void flush() override;
 
         // Get and set the columns of text available in the console.
         // Zero is a special value meaning that the columns are
@@ -32,6 +52,14 @@ namespace archetype {
         
         // Set cursor back to the left margin.
         void resetCursor();
+        int cursor() const { return cursor_; }
+
+        // Wrap text exactly as the equivalent puts and endLines would from the
+        // current cursor, without writing anything.  The result may be written
+        // with putWrapped any number of times, as long as the width and cursor
+        // are the same as they were here.
+        WrappedText wrap(const TextPieces& text) const;
+        void putWrapped(const WrappedText& wrapped);
     };
 }
 
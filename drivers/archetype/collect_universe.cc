@@ -0,0 +1,76 @@
+//
+//  collect_universe.cc
+//  archetype
+//
+//
+
+#include <set>
+#include <stack>
+#include <vector>
+
+#include "collect_universe.hh"
+#include "Expression.hh"
+#include "Universe.hh"
+
+using namespace std;
+
+namespace archetype {
+
+    static void reach_object(References& refs, const ObjectPtr& obj) {
+        if (obj and obj->id() != Object::INVALID) {
+            refs.objects.insert(obj->id());
+        }
+    }
+
+    int collect_universe() {
+        Universe& u = Universe::instance();
+
+        References roots;
+        roots.objects = {Universe::NullObjectId, Universe::SystemObjectId};
+        for (auto const& named : u.ObjectIdentifiers) {
+            roots.objects.insert(named.second);
+        }
+        for (int id = Universe::UserObjectsBeginAt; id < u.objectCount(); ++id) {
+            ObjectPtr obj = u.getObject(id);
+            if (obj and obj->isPrototype()) {
+                roots.objects.insert(id);
+            }
+        }
+        for (stack<Universe::Context> contexts = u.context_; not contexts.empty(); contexts.pop()) {
+            const Universe::Context& context = contexts.top();
+            reach_object(roots, context.selfObject);
+            reach_object(roots, context.senderObject);
+            reach_object(roots, context.eachObject);
+            roots.gather(context.messageValue);
+        }
+
+        // Identifiers need not be followed:  any object they name is a root already.
+        set<int> reached;
+        vector<int> pending(roots.objects.begin(), roots.objects.end());
+        while (not pending.empty()) {
+            int id = pending.back();
+            pending.pop_back();
+            ObjectPtr obj = u.getObject(id);
+            if (not obj or not reached.insert(id).second) {
+                continue;
+            }
+            References refs;
+            obj->gatherReferences(refs);
+            for (int referred : refs.objects) {
+                if (not reached.count(referred)) {
+                    pending.push_back(referred);
+                }
+            }
+        }
+
+        int destroyed = 0;
+        for (int id = Universe::UserObjectsBeginAt; id < u.objectCount(); ++id) {
+            if (u.getObject(id) and not reached.count(id)) {
+                u.destroyObject(id);
+                destroyed++;
+            }
+        }
+        return destroyed;
+    }
+
+}
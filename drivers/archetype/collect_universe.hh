@@ -0,0 +1,29 @@
+//
+//  collect_universe.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__collect_universe__
+#define __archetype__collect_universe__
+
+namespace archetype {
+
+    // Destroy every instance a running game can no longer reach, and return how
+    // many there were.  Instances made with 'create' and then forgotten otherwise
+    // stay in the Universe for good, to be loaded and saved again every turn.
+    //
+    // What can be reached starts from every named object, every prototype, the
+    // null and system objects, the objects and messages of every context being run,
+    // and the objects the system parser knows of; from there, the parent of a
+    // reached object and anything its attributes and methods hold or name are
+    // reached too.  Only unnamed instances that are none of these are destroyed.
+    //
+    // A 'for each' can still come upon an instance nothing else reaches, so this is
+    // only done for games that ask for it; see Universe::collectsGarbage.  Nor can
+    // it see an object held only by an expression part way through evaluating.
+    int collect_universe();
+
+}
+
+#endif // __archetype__collect_universe__
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <iterator>
 #include <string>
 
 #include "inspect_universe.hh"
@@ -57,8 +58,8 @@ namespace archetype {
             // This is the flat, not the inherited, view of the attributes and methods.
             // Only what is added by each type.
             for (auto const& attr : obj->attributes_) {
-                // Archetype has an endearing (sigh) way of instantiating any attributes that have even been
-                // observed with UNDEFINED.  This is one reason why saved games have greater size.
+                // Attributes only ever read are kept apart, in unset_, but one can still be assigned
+                // UNDEFINED outright.
                 const bool hide_undefined = true;
                 auto value = dynamic_cast<const ValueExpression*>(attr.second.get());
                 if (!hide_undefined  or  (value and value->evaluate()->isDefined())) {
@@ -11,11 +11,14 @@
 #include <iterator>
 #include <algorithm>
 #include <map>
+#include <set>
 #include <list>
 #include <string>
+#include <vector>
 #include <fstream>
 
 #include "TestRegistry.hh"
+#include "BenchRegistry.hh"
 #include "ReadEvalPrintLoop.hh"
 #include "SourceFile.hh"
 #include "TokenStream.hh"
@@ -26,9 +29,18 @@
 #include "Keywords.hh"
 #include "FileStorage.hh"
 #include "Wellspring.hh"
+#include "ModuleCache.hh"
+#include "NodePool.hh"
+#include "ComputedAttributes.hh"
+#include "Profiler.hh"
+#include "Trace.hh"
+#include "TurnLimits.hh"
+#include "UndoHistory.hh"
 
 #include "update_universe.hh"
 #include "inspect_universe.hh"
+#include "replay_universe.hh"
+#include "strip_universe.hh"
 
 
 #if NDEBUG
@@ -64,8 +76,21 @@ namespace archetype {
                 output->put(VersionString);
                 output->endLine();
             }
+            if (Profiler::Enabled) {
+                Profiler::instance().finish();
+            }
+            Profiler::destroy();
+            if (Trace::Enabled) {
+                Trace::instance().dump();
+            }
+            Trace::destroy();
+            TurnLimits::destroy();
             TestRegistry::destroy();
+            BenchRegistry::destroy();
             Universe::destroy();
+            NodePool::destroy();
+            ComputedAttributes::destroy();
+            ModuleCache::destroy();
             Wellspring::destroy();
             Keywords::destroy();
         }
@@ -86,19 +111,36 @@ void usage() {
         << endl
         << " --help                  Print this message and exit." << endl
         << " --test                  Run all test suites." << endl
+        << " --bench[=filter]        Run the benchmarks whose names contain filter; print the results as JSON." << endl
+        << "   --repetitions=N           Timed samples taken of each benchmark." << endl
         << " --repl                  Enter the REPL (Read-Eval-Print Loop)." << endl
         << " --silent                Produce only game output and no other advisory output." << endl
         << " --source=file.ach       Read, compile, and run the given program." << endl
         << "   --include=path[:path...]  Colon-separated list of paths to search for source." << endl
         << "   --create[=file.acx]       Don't run, but write the program given by --source to a binary file." << endl
+        << "   --cache=directory         Keep compiled include files in the given directory and reuse them." << endl
+        << "   --strip[=messages.txt]    With --create, leave out what 'START' and 'UPDATE' -> main cannot reach." << endl
+        << "                             Messages only ever sent by names built at run time go one per line in the file." << endl
+        << " --profile=file          Time every method and statement run; append folded stacks to the file at exit." << endl
+        << " --trace=file            Keep a ring buffer of the most recent sends and attribute accesses; write it to the file at exit or on error." << endl
         << " --perform=file.acx      Load a saved binary file and send 'START' -> main." << endl
         << " --update=file.acx       Load binary, send 'UPDATE' -> main, save resulting binary to the same file." << endl
         << "   --input <string>          In combination with --update, provide command input as a string." << endl
+        << "                             A turn asking for more input waits for it in the next --update." << endl
+        << "   --max-statements=N        Abandon a turn, keeping the file as it was, after N statements." << endl
+        << "   --max-depth=N             Abandon a turn whose sends and passes nest more than N deep (default 1000)." << endl
+        << "   --max-time=ms             Abandon a turn that runs longer than the given milliseconds." << endl
+        << "   --collect                 Before saving, destroy unnamed instances the game can no longer reach." << endl
+        << " --replay=file.ach|.acx  Play a transcript against the game, one 'UPDATE' per line, and report timings." << endl
+        << "   --transcript=file         The commands to play, one per line." << endl
+        << "   --sessions=N              Run N independent sessions in parallel." << endl
+        << "   --round-trip              Load and save the universe around every turn, as --update does." << endl
+        << "   --seed=N                  Seed for the random operator; sessions use N, N+1, ..." << endl
+        << "   --undo-turns              Snapshot at the start of every turn, so that 'UNDO' -> system goes back a turn; not with --round-trip." << endl
     ;
 }
 
-static void from_source(map<std::string, std::string> &opts) {
-    string source_path = opts["source"];
+static void compile(map<std::string, std::string> &opts, string source_path) {
     SourceFilePtr source = Wellspring::instance().primarySource(source_path);
     if (not source) {
         throw invalid_argument("Cannot open \"" + source_path + "\"");
@@ -111,11 +153,21 @@ static void from_source(map<std::string, std::string> &opts) {
         Wellspring::instance().addSearchPath(path);
       }
     }
+    if (opts.count("cache")) {
+        ModuleCache::instance().setDirectory(opts["cache"]);
+    }
     TokenStream tokens(source);
     if (not Universe::instance().make(tokens)) {
         throw CompilationFailure();
     }
     Universe::instance().reportUndefinedIdentifiers();
+    Universe::instance().bindIdentifiers();
+    Universe::instance().output()->flush();
+}
+
+static void from_source(map<std::string, std::string> &opts) {
+    string source_path = opts["source"];
+    compile(opts, source_path);
     if (not opts.count("create")) {
         dispatch_to_universe("START");
     } else {
@@ -131,6 +183,20 @@ static void from_source(map<std::string, std::string> &opts) {
         if (source_path == filename_out) {
             throw invalid_argument("Cannot use " + filename_out + " as output");
         }
+        if (opts.count("strip")) {
+            set<string> keep_messages;
+            if (not opts["strip"].empty()) {
+                ifstream keep_in(opts["strip"].c_str());
+                if (not keep_in) {
+                    throw invalid_argument("Cannot read from " + opts["strip"]);
+                }
+                keep_messages = read_message_list(keep_in);
+            }
+            StripReport stripped = strip_universe(keep_messages);
+            cout << "Stripped " << stripped.methods << " methods, " << stripped.objects << " objects, "
+                 << stripped.messages << " messages, " << stripped.textLiterals << " text literals and "
+                 << stripped.identifiers << " identifiers" << endl;
+        }
         OutFileStorage save_file(filename_out);
         if (save_file.ok()) {
             save_file << Universe::instance();
@@ -170,11 +236,50 @@ int main(int argc, const char* argv[]) {
     if (opts.count("silent")) {
         session.silent(true);
     }
+    if (opts.count("profile")) {
+        Profiler::instance().start(opts["profile"]);
+    }
+    if (opts.count("trace")) {
+        Trace::instance().setDumpPath(opts["trace"]);
+        Trace::instance().enable();
+    }
+    if (opts.count("max-statements")) {
+        TurnLimits::instance().setMaxStatements(stoll(opts["max-statements"]));
+    }
+    if (opts.count("max-depth")) {
+        TurnLimits::instance().setMaxSendDepth(stoi(opts["max-depth"]));
+    } else if (opts.count("update")) {
+        // Far deeper than any game needs, but well short of running out of stack.
+        TurnLimits::instance().setMaxSendDepth(TurnLimits::DefaultMaxSendDepth);
+    }
+    if (opts.count("max-time")) {
+        TurnLimits::instance().setMaxMilliseconds(stoi(opts["max-time"]));
+    }
+    if (opts.count("collect")) {
+        Universe::instance().setCollectsGarbage(true);
+    }
+    if (opts.count("undo-turns")) {
+        UndoHistory::EveryTurn = true;
+    }
     if (opts.count("test")) {
         bool success = TestRegistry::instance().runAllTestSuites(cout);
         int exit_code = success ? 0 : 1;
         return exit_code;
     }
+    if (opts.count("bench")) {
+        session.silent(true);
+        int repetitions = BenchRegistry::DefaultRepetitions;
+        if (opts.count("repetitions")) {
+            repetitions = stoi(opts["repetitions"]);
+        }
+        try {
+            BenchRegistry::instance().runBenchmarks(opts["bench"], repetitions, cout);
+        } catch (const std::exception& e) {
+            cerr << "ERROR: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
     if (opts.count("repl")) {
         int errors = repl();
         return errors;
@@ -254,6 +359,51 @@ int main(int argc, const char* argv[]) {
             cerr << "ERROR: " << e.what() << endl;
             return 1;
         }
+    } else if (opts.count("replay")) {
+        string filename = opts["replay"];
+        ReplayOptions options{1, opts.count("round-trip") > 0, 80, 0};
+        if (opts.count("sessions")) {
+            options.sessions = stoi(opts["sessions"]);
+        }
+        if (opts.count("width")) {
+            options.width = stoi(opts["width"]);
+        }
+        if (opts.count("seed")) {
+            options.seed = static_cast<unsigned>(stoul(opts["seed"]));
+        }
+        try {
+            vector<Storage::Byte> game;
+            string ach = ".ach";
+            if (filename.size() > ach.size() and
+                filename.compare(filename.size() - ach.size(), ach.size(), ach) == 0) {
+                compile(opts, filename);
+                MemoryStorage compiled;
+                compiled << Universe::instance();
+                game.swap(compiled.bytes());
+            } else {
+                if (filename.rfind('.') == string::npos) {
+                    filename += ".acx";
+                }
+                ifstream f_in(filename.c_str());
+                if (!f_in) {
+                    throw invalid_argument("Cannot read from " + filename);
+                }
+                copy(istreambuf_iterator<char>{f_in}, {}, back_inserter(game));
+            }
+            if (not opts.count("transcript")) {
+                throw invalid_argument("--replay needs a --transcript");
+            }
+            ifstream transcript(opts["transcript"].c_str());
+            if (!transcript) {
+                throw invalid_argument("Cannot read from " + opts["transcript"]);
+            }
+            session.silent(true);
+            int failures = replay_universe(game, read_transcript(transcript), options, cout);
+            return failures ? 1 : 0;
+        } catch (const std::exception& e) {
+            cerr << "ERROR: " << e.what() << endl;
+            return 1;
+        }
     }
     return 0;
 }
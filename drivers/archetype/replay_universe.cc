@@ -0,0 +1,281 @@
+//
+//  replay_universe.cc
+//  archetype
+//
+//
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <stdexcept>
+
+#include "replay_universe.hh"
+#include "update_universe.hh"
+#include "Expression.hh"
+#include "Universe.hh"
+#include "WrappedOutput.hh"
+#include "StringInput.hh"
+#include "StringOutput.hh"
+
+using namespace std;
+
+// Allocations are counted only while a replay is timing a turn, so that it can
+// report how many each turn made; everywhere else, including --update, --test and
+// the REPL, the hook does nothing but test the flag.  There is only ever one
+// thread; parallel sessions run in separate processes.
+static bool CountingAllocations = false;
+static long long Allocations = 0;
+
+void* operator new(size_t size) {
+    if (CountingAllocations) {
+        ++Allocations;
+    }
+    if (void* p = malloc(size ? size : 1)) {
+        return p;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+namespace archetype {
+
+    struct TurnSample {
+        long long nanoseconds;
+        long long allocations;
+        long long bytes;
+    };
+
+    vector<string> read_transcript(istream& in) {
+        vector<string> commands;
+        string line;
+        while (getline(in, line)) {
+            if (not line.empty() and line[line.size() - 1] == '\r') {
+                line.erase(line.size() - 1);
+            }
+            if (not line.empty() and line[0] != '#') {
+                commands.push_back(line);
+            }
+        }
+        return commands;
+    }
+
+    static void play_session(const vector<Storage::Byte>& game,
+                             const vector<string>& commands,
+                             const ReplayOptions& options,
+                             vector<TurnSample>& samples) {
+        Universe& u = Universe::instance();
+        UserOutput previous_output = u.output();
+        UserInput previous_input = u.input();
+        vector<Storage::Byte> state = game;
+        if (not options.roundTrip) {
+            MemoryStorage in;
+            in.bytes().swap(state);
+            in >> u;
+        }
+        try {
+            for (auto const& command : commands) {
+                TurnSample sample{0, 0, 0};
+                if (options.roundTrip) {
+                    MemoryStorage in;
+                    MemoryStorage out;
+                    in.bytes() = state;
+                    long long allocations = Allocations;
+                    CountingAllocations = true;
+                    auto start = chrono::steady_clock::now();
+                    try {
+                        update_universe(in, out, command, options.width);
+                    } catch (...) {
+                        CountingAllocations = false;
+                        throw;
+                    }
+                    auto finish = chrono::steady_clock::now();
+                    CountingAllocations = false;
+                    sample.allocations = Allocations - allocations;
+                    sample.nanoseconds = chrono::duration_cast<chrono::nanoseconds>(finish - start).count();
+                    sample.bytes = out.bytes().size();
+                    state.swap(out.bytes());
+                } else {
+                    UserOutput str_output{new StringOutput};
+                    u.setOutput(UserOutput{new WrappedOutput{str_output, options.width}});
+                    u.setInput(UserInput{new StringInput{command}});
+                    long long allocations = Allocations;
+                    CountingAllocations = true;
+                    auto start = chrono::steady_clock::now();
+                    try {
+                        dispatch_to_universe("UPDATE");
+                    } catch (const QuitGame&) {
+                        u.endItAll();
+                    } catch (...) {
+                        CountingAllocations = false;
+                        throw;
+                    }
+                    auto finish = chrono::steady_clock::now();
+                    CountingAllocations = false;
+                    sample.allocations = Allocations - allocations;
+                    sample.nanoseconds = chrono::duration_cast<chrono::nanoseconds>(finish - start).count();
+                }
+                samples.push_back(sample);
+                if (u.ended()) {
+                    break;
+                }
+            }
+        } catch (...) {
+            u.setOutput(previous_output);
+            u.setInput(previous_input);
+            throw;
+        }
+        u.setOutput(previous_output);
+        u.setInput(previous_input);
+    }
+
+    static void write_fully(int fd, const char* buf, size_t nbytes) {
+        while (nbytes > 0) {
+            ssize_t written = write(fd, buf, nbytes);
+            if (written <= 0) {
+                return;
+            }
+            buf += written;
+            nbytes -= written;
+        }
+    }
+
+    static void read_samples(int fd, vector<TurnSample>& samples) {
+        TurnSample sample;
+        char* buf = reinterpret_cast<char*>(&sample);
+        size_t filled = 0;
+        ssize_t got;
+        while ((got = read(fd, buf + filled, sizeof(sample) - filled)) > 0) {
+            filled += got;
+            if (filled == sizeof(sample)) {
+                samples.push_back(sample);
+                filled = 0;
+            }
+        }
+    }
+
+    // Nearest-rank percentile of values already sorted ascending.
+    static long long percentile(const vector<long long>& sorted, double p) {
+        if (sorted.empty()) {
+            return 0;
+        }
+        size_t rank = static_cast<size_t>(ceil(p / 100.0 * sorted.size()));
+        return sorted[max<size_t>(rank, 1) - 1];
+    }
+
+    static void report_row(ostream& report, string title, vector<long long> values, double scale) {
+        sort(values.begin(), values.end());
+        double total = 0;
+        for (long long v : values) {
+            total += v;
+        }
+        double mean = values.empty() ? 0 : total / values.size();
+        report << left << setw(16) << title << right << fixed << setprecision(scale == 1.0 ? 0 : 1);
+        for (double p : {50.0, 95.0, 99.0}) {
+            report << setw(12) << percentile(values, p) / scale;
+        }
+        report << setw(12) << (values.empty() ? 0 : values.back()) / scale
+               << setw(12) << mean / scale << endl;
+    }
+
+    int replay_universe(const vector<Storage::Byte>& game,
+                        const vector<string>& commands,
+                        const ReplayOptions& options,
+                        ostream& report) {
+        if (options.sessions < 1) {
+            throw invalid_argument("Need at least one session to replay");
+        }
+        vector<TurnSample> samples;
+        int failures = 0;
+        auto start = chrono::steady_clock::now();
+        if (options.sessions == 1) {
+            seed_random(options.seed);
+            try {
+                play_session(game, commands, options, samples);
+            } catch (const std::exception& e) {
+                report << "ERROR: " << e.what() << endl;
+                failures++;
+            }
+        } else {
+            // The Universe is a singleton, so each session gets a process of its own.
+            Universe::instance().output()->flush();
+            report.flush();
+            vector<pair<pid_t, int>> children;
+            for (int s = 0; s < options.sessions; ++s) {
+                int fds[2];
+                if (pipe(fds) != 0) {
+                    throw runtime_error("Cannot create a pipe for session " + to_string(s + 1));
+                }
+                pid_t pid = fork();
+                if (pid < 0) {
+                    throw runtime_error("Cannot start session " + to_string(s + 1));
+                }
+                if (pid == 0) {
+                    close(fds[0]);
+                    int exit_code = 0;
+                    vector<TurnSample> session_samples;
+                    seed_random(options.seed + s);
+                    try {
+                        play_session(game, commands, options, session_samples);
+                    } catch (const std::exception& e) {
+                        cerr << "Session " << (s + 1) << ": ERROR: " << e.what() << endl;
+                        exit_code = 1;
+                    }
+                    write_fully(fds[1], reinterpret_cast<const char*>(session_samples.data()),
+                                session_samples.size() * sizeof(TurnSample));
+                    close(fds[1]);
+                    _exit(exit_code);
+                }
+                close(fds[1]);
+                children.push_back(make_pair(pid, fds[0]));
+            }
+            for (auto const& child : children) {
+                read_samples(child.second, samples);
+                close(child.second);
+                int status = 0;
+                waitpid(child.first, &status, 0);
+                if (not WIFEXITED(status) or WEXITSTATUS(status) != 0) {
+                    failures++;
+                }
+            }
+        }
+        auto finish = chrono::steady_clock::now();
+
+        vector<long long> latencies, allocations, bytes;
+        for (auto const& sample : samples) {
+            latencies.push_back(sample.nanoseconds);
+            allocations.push_back(sample.allocations);
+            bytes.push_back(sample.bytes);
+        }
+        report << "Replayed " << samples.size() << " turns of " << commands.size()
+               << " commands in " << options.sessions << " session(s)"
+               << (options.roundTrip ? ", loading and saving the universe each turn" : "") << endl;
+        report << left << setw(16) << "" << right;
+        for (string heading : {"p50", "p95", "p99", "max", "mean"}) {
+            report << setw(12) << heading;
+        }
+        report << endl;
+        report_row(report, "latency (us)", latencies, 1000.0);
+        report_row(report, "allocations", allocations, 1.0);
+        if (options.roundTrip) {
+            report_row(report, "bytes saved", bytes, 1.0);
+        }
+        report << "Elapsed: " << fixed << setprecision(1)
+               << chrono::duration_cast<chrono::microseconds>(finish - start).count() / 1000.0
+               << " ms" << endl;
+        if (failures) {
+            report << "Sessions failed: " << failures << endl;
+        }
+        return failures;
+    }
+
+}
@@ -0,0 +1,43 @@
+//
+//  replay_universe.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__replay_universe__
+#define __archetype__replay_universe__
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Serialization.hh"
+
+namespace archetype {
+
+    struct ReplayOptions {
+        // Independent sessions to run at once, each in its own process.
+        int sessions;
+        // Load and save the whole universe around every turn, as --update does,
+        // rather than only sending 'UPDATE' to a universe kept in memory.
+        bool roundTrip;
+        int width;
+        unsigned seed;
+    };
+
+    // One command per line.  Blank lines and lines starting with '#' are skipped, since
+    // an empty command reads as the end of input and ends most games.
+    std::vector<std::string> read_transcript(std::istream& in);
+
+    // Play every command of the transcript, one 'UPDATE' per command, against a
+    // universe starting from the given serialized game, and report the latency,
+    // allocations and bytes serialized of the turns.  Returns the number of
+    // sessions that failed.
+    int replay_universe(const std::vector<Storage::Byte>& game,
+                        const std::vector<std::string>& commands,
+                        const ReplayOptions& options,
+                        std::ostream& report);
+
+}
+
+#endif // __archetype__replay_universe__
@@ -0,0 +1,162 @@
+//
+//  strip_universe.cc
+//  archetype
+//
+//
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "strip_universe.hh"
+#include "Expression.hh"
+#include "Statement.hh"
+#include "Universe.hh"
+
+using namespace std;
+
+namespace archetype {
+
+    set<string> read_message_list(istream& in) {
+        set<string> names;
+        string line;
+        while (getline(in, line)) {
+            if (not line.empty() and line[line.size() - 1] == '\r') {
+                line.erase(line.size() - 1);
+            }
+            if (not line.empty() and line[0] != '#') {
+                names.insert(line);
+            }
+        }
+        return names;
+    }
+
+    // Drop every live entry of the index that keep does not want, and count them.
+    template <class Keep>
+    static int remove_unwanted(StringIdIndex& index, Keep keep) {
+        int removed = 0;
+        for (int id = 0; id < index.count(); ++id) {
+            // Holes hold the empty string, which may also be a real entry elsewhere.
+            if (index.find(index.get(id)) == id and not keep(id)) {
+                index.remove(id);
+                removed++;
+            }
+        }
+        return removed;
+    }
+
+    StripReport strip_universe(const set<string>& keep_messages) {
+        Universe& u = Universe::instance();
+        ObjectPtr main_object = u.getObject("main");
+        if (not main_object) {
+            throw invalid_argument("Cannot strip a program without a main object");
+        }
+
+        References refs;
+        refs.objects = {Universe::NullObjectId, Universe::SystemObjectId, main_object->id()};
+        set<string> start_messages = keep_messages;
+        start_messages.insert("START");
+        start_messages.insert("UPDATE");
+        for (auto const& name : start_messages) {
+            int message_id = u.Messages.find(name);
+            if (message_id != StringIdIndex::npos) {
+                refs.messages.insert(message_id);
+            }
+        }
+
+        // Gathering from one object or method can reach more of both, so go round
+        // until a pass finds nothing new.
+        set<int> scanned_objects;
+        set<pair<int, int>> scanned_methods;
+        size_t reached = 0;
+        while (true) {
+            if (refs.eachObject) {
+                for (int id = Universe::UserObjectsBeginAt; id < u.objectCount(); ++id) {
+                    ObjectPtr obj = u.getObject(id);
+                    if (obj and not obj->isPrototype()) {
+                        refs.objects.insert(id);
+                    }
+                }
+            }
+            if (refs.namedSends) {
+                for (int literal : refs.textLiterals) {
+                    int message_id = u.Messages.find(u.TextLiterals.get(literal));
+                    if (message_id != StringIdIndex::npos) {
+                        refs.messages.insert(message_id);
+                    }
+                }
+            }
+            for (int identifier : refs.identifiers) {
+                auto named = u.ObjectIdentifiers.find(identifier);
+                if (named != u.ObjectIdentifiers.end()) {
+                    refs.objects.insert(named->second);
+                }
+            }
+            vector<int> objects(refs.objects.begin(), refs.objects.end());
+            for (int id : objects) {
+                ObjectPtr obj = u.getObject(id);
+                if (not obj) {
+                    continue;
+                }
+                if (scanned_objects.insert(id).second) {
+                    if (obj->parentId() >= 0) {
+                        refs.objects.insert(obj->parentId());
+                    }
+                    for (auto const& attribute : obj->attributes_) {
+                        refs.identifiers.insert(attribute.first);
+                        attribute.second->gatherReferences(refs);
+                    }
+                    refs.identifiers.insert(obj->unset_.begin(), obj->unset_.end());
+                }
+                for (auto const& method : obj->methods_) {
+                    if ((method.first == DefaultMethod or refs.messages.count(method.first)) and
+                        scanned_methods.insert(make_pair(id, method.first)).second) {
+                        method.second->gatherReferences(refs);
+                    }
+                }
+            }
+            size_t now_reached = refs.objects.size() + refs.messages.size() + refs.textLiterals.size() +
+                                 refs.identifiers.size() + scanned_methods.size() +
+                                 refs.namedSends + refs.eachObject;
+            if (now_reached == reached) {
+                break;
+            }
+            reached = now_reached;
+        }
+
+        StripReport report{0, 0, 0, 0, 0};
+        for (int id = Universe::UserObjectsBeginAt; id < u.objectCount(); ++id) {
+            ObjectPtr obj = u.getObject(id);
+            if (not obj) {
+                continue;
+            }
+            if (not refs.objects.count(id)) {
+                u.destroyObject(id);
+                report.objects++;
+                continue;
+            }
+            for (auto method = obj->methods_.begin(); method != obj->methods_.end();) {
+                if (method->first == DefaultMethod or refs.messages.count(method->first)) {
+                    ++method;
+                } else {
+                    method = obj->methods_.erase(method);
+                    report.methods++;
+                }
+            }
+        }
+        for (auto named = u.ObjectIdentifiers.begin(); named != u.ObjectIdentifiers.end();) {
+            if (u.getObject(named->second)) {
+                refs.identifiers.insert(named->first);
+                ++named;
+            } else {
+                named = u.ObjectIdentifiers.erase(named);
+            }
+        }
+
+        report.messages = remove_unwanted(u.Messages, [&](int id) { return refs.messages.count(id) > 0; });
+        report.textLiterals = remove_unwanted(u.TextLiterals, [&](int id) { return refs.textLiterals.count(id) > 0; });
+        report.identifiers = remove_unwanted(u.Identifiers, [&](int id) { return refs.identifiers.count(id) > 0; });
+        return report;
+    }
+
+}
@@ -0,0 +1,43 @@
+//
+//  strip_universe.hh
+//  archetype
+//
+//
+
+#ifndef __archetype__strip_universe__
+#define __archetype__strip_universe__
+
+#include <iostream>
+#include <set>
+#include <string>
+
+namespace archetype {
+
+    struct StripReport {
+        int methods;
+        int objects;
+        int messages;
+        int textLiterals;
+        int identifiers;
+    };
+
+    // Leave out of a compiled Universe whatever 'START' and 'UPDATE' -> main cannot
+    // reach:  methods for messages that are never sent, objects that are never
+    // named, and the messages, text literals and identifiers nothing left refers to.
+    //
+    // Every method of every kept object for a message the program sends is kept,
+    // whichever object it is sent to, and a 'for each' keeps every instance.  A send
+    // of something other than a message literal could be of a message named by a
+    // string, so any message named by a kept text literal is then kept too.  A
+    // message only ever named by a string built while the game runs cannot be seen
+    // here, and must be given in keep_messages.
+    //
+    // Entries are removed without renumbering, so nothing compiled needs changing.
+    StripReport strip_universe(const std::set<std::string>& keep_messages);
+
+    // One message name per line; blank lines and lines starting with '#' are skipped.
+    std::set<std::string> read_message_list(std::istream& in);
+
+}
+
+#endif // __archetype__strip_universe__
@@ -5,9 +5,17 @@
 #include "Universe.hh"
 #include "WrappedOutput.hh"
 #include "ConsoleOutput.hh"
-#include "StringInput.hh"
 #include "StringOutput.hh"
 #include "Value.hh"
+#include "Trace.hh"
+#include "TurnLimits.hh"
+#include "Expression.hh"
+#include "collect_universe.hh"
+
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
 
 namespace archetype {
 
@@ -20,7 +28,7 @@ namespace archetype {
     { }
 
     virtual char getKey() override {
-      std::string key_str(input_->getKey(), 1);
+      std::string key_str(1, input_->getKey());
       output_->put(key_str);
       return key_str[0];
     }
@@ -42,6 +50,115 @@ namespace archetype {
 
   };
 
+  // The input of one turn: the command, then the answers to whatever the game has
+  // asked since.  Reads past the end of it suspend the turn, except for the very
+  // first, which finds the end of input as always.
+  class TurnInput : public IUserInput {
+
+  public:
+    TurnInput(const std::vector<std::string>& answers):
+      line_(0),
+      column_(0),
+      read_(false)
+    {
+      for (auto const& answer : answers) {
+        std::istringstream in(answer);
+        std::string line;
+        while (std::getline(in, line)) {
+          lines_.push_back(line);
+        }
+        if (answer.empty() or answer[answer.size() - 1] == '\n') {
+          lines_.push_back("");
+        }
+      }
+    }
+
+    virtual char getKey() override {
+      for (; line_ < lines_.size(); ++line_, column_ = 0) {
+        const std::string& line = lines_[line_];
+        while (column_ < line.size() and std::isspace(static_cast<unsigned char>(line[column_]))) {
+          ++column_;
+        }
+        if (column_ < line.size()) {
+          read_ = true;
+          return line[column_++];
+        }
+      }
+      exhausted_();
+      return '\0';
+    }
+
+    virtual std::string getLine() override {
+      if (line_ >= lines_.size()) {
+        exhausted_();
+        return "";
+      }
+      read_ = true;
+      std::string line = lines_[line_++].substr(column_);
+      column_ = 0;
+      return line;
+    }
+
+    virtual bool atEOF() const override {
+      return line_ >= lines_.size();
+    }
+
+  private:
+    std::vector<std::string> lines_;
+    size_t line_;
+    size_t column_;
+    bool read_;
+
+    void exhausted_() const {
+      if (read_) {
+        throw InputSuspended();
+      }
+    }
+
+  };
+
+  // A suspended turn, kept after the Universe as it was before the turn began.
+  // Since the interpreter's stack cannot be saved, the turn is resumed by running
+  // it again from the start with the same random numbers and all the answers so
+  // far; the output already delivered is not delivered again.  That output is kept
+  // too, since a turn that does not run the same way again cannot be resumed.
+  struct SuspendedTurn {
+    unsigned seed;
+    int delivered;
+    std::vector<std::string> answers;
+    std::string shown;
+  };
+
+  Storage& operator<<(Storage& out, const SuspendedTurn& turn) {
+    out << static_cast<int>(turn.seed) << turn.delivered << static_cast<int>(turn.answers.size());
+    for (auto const& answer : turn.answers) {
+      out << answer;
+    }
+    out << turn.shown;
+    return out;
+  }
+
+  Storage& operator>>(Storage& in, SuspendedTurn& turn) {
+    int seed, entries;
+    in >> seed >> turn.delivered >> entries;
+    turn.seed = static_cast<unsigned>(seed);
+    turn.answers.resize(entries);
+    for (auto& answer : turn.answers) {
+      in >> answer;
+    }
+    // Turns suspended before the output was kept can only be taken on trust.
+    if (in.remaining() > 0) {
+      in >> turn.shown;
+    } else {
+      turn.shown.clear();
+    }
+    return in;
+  }
+
+  static bool replayed(const std::string& output, const SuspendedTurn& turn) {
+    return output.compare(0, turn.shown.size(), turn.shown) == 0;
+  }
+
 using namespace std;
 
 Value dispatch_to_universe(string message) {
@@ -52,9 +169,31 @@ Value dispatch_to_universe(string message) {
   if (Universe::instance().ended()) {
     throw invalid_argument("Universe has ended");
   }
+  if (TurnLimits::Enabled) {
+    TurnLimits::instance().beginTurn();
+  }
+  if (message == "UPDATE" and UndoHistory::EveryTurn) {
+    Universe::instance().History.beginTurn();
+  }
   int start_id = Universe::instance().Messages.index(message);
   Value start{new MessageValue{start_id}};
-  Value result = Object::send(main_object, std::move(start));
+  Value result;
+  try {
+    result = Object::send(main_object, std::move(start));
+  } catch (const QuitGame&) {
+    Universe::instance().output()->flush();
+    throw;
+  } catch (const InputSuspended&) {
+    Universe::instance().output()->flush();
+    throw;
+  } catch (...) {
+    Universe::instance().output()->flush();
+    if (Trace::Enabled) {
+      Trace::instance().dump();
+    }
+    throw;
+  }
+  Universe::instance().output()->flush();
   if (result->isSameValueAs(Value{new AbsentValue})) {
     throw invalid_argument("No method for '" + message + "' on main object");
   }
@@ -67,17 +206,78 @@ string update_universe(Storage& in, Storage& out, string input, int width) {
   UserOutput wrapped{new WrappedOutput{str_output, width}};
   Universe::instance().setOutput(wrapped);
   UserOutput user_output = Universe::instance().output();
-  UserInput str_input{new StringInput{input}};
-  UserInput echo_input{new EchoingInput(str_input, user_output)};
-  Universe::instance().setInput(echo_input);
+  // Keep the state as it was before the turn, in case the turn must be abandoned
+  // or suspended.
+  MemoryStorage* memory_in = dynamic_cast<MemoryStorage*>(&in);
+  int universe_begins = static_cast<int>(memory_in ? memory_in->bytes().size() : 0) - in.remaining();
   in >> Universe::instance();
+  vector<Storage::Byte> before;
+  if (memory_in) {
+    auto universe_ends = memory_in->bytes().end() - in.remaining();
+    before.assign(memory_in->bytes().begin() + universe_begins, universe_ends);
+  }
+  SuspendedTurn turn{0, 0, {}, {}};
+  bool resuming = in.remaining() > 0;
+  if (resuming) {
+    in >> turn;
+  } else {
+    turn.seed = draw_random_seed();
+  }
+  turn.answers.push_back(input);
+  seed_random(turn.seed);
+  UserInput turn_input{new TurnInput{turn.answers}};
+  UserInput echo_input{new EchoingInput(turn_input, user_output)};
+  Universe::instance().setInput(echo_input);
+  StringOutput* output = dynamic_cast<StringOutput*>(str_output.get());
+  int delivered = turn.delivered;
+  // A resumed turn that does not repeat what it showed has gone another way, and
+  // cannot be finished.  It is abandoned, leaving the Universe as it was before
+  // the turn, so the next update begins a new one.
+  auto abandon_diverged = [&]() {
+    if (not memory_in) {
+      throw runtime_error("Resumed turn did not repeat what it had already shown");
+    }
+    out.write(before.data(), static_cast<int>(before.size()));
+    return string("That turn could not be resumed, so it was abandoned.\n");
+  };
   try {
     dispatch_to_universe("UPDATE");
   } catch (const archetype::QuitGame&) {
     Universe::instance().endItAll();
+  } catch (const InputSuspended&) {
+    if (not memory_in) {
+      throw;
+    }
+    if (not replayed(output->getOutput(), turn)) {
+      return abandon_diverged();
+    }
+    turn.delivered = static_cast<int>(output->getOutput().size());
+    turn.shown = output->getOutput();
+    out.write(before.data(), static_cast<int>(before.size()));
+    out << turn;
+    return output->getOutput().substr(delivered);
+  } catch (const TurnLimitExceeded& e) {
+    if (not memory_in) {
+      throw;
+    }
+    if (not replayed(output->getOutput(), turn)) {
+      return abandon_diverged();
+    }
+    user_output->endLine();
+    user_output->put(e.what());
+    user_output->endLine();
+    user_output->flush();
+    out.write(before.data(), static_cast<int>(before.size()));
+    return output->getOutput().substr(delivered);
+  }
+  if (not replayed(output->getOutput(), turn)) {
+    return abandon_diverged();
+  }
+  if (Universe::instance().collectsGarbage()) {
+    collect_universe();
   }
   out << Universe::instance();
-  return dynamic_cast<StringOutput*>(str_output.get())->getOutput();
+  return output->getOutput().substr(delivered);
 }
 
 } // namespace archetype
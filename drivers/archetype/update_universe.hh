@@ -10,12 +10,24 @@
 #define __archetype__update_universe__
 
 #include <string>
+#include <stdexcept>
 #include "Value.hh"
 #include "Serialization.hh"
 
 namespace archetype {
 
+  // Thrown when a game asks for more input than an update was given.  The turn
+  // is suspended, to be finished by the next update, which brings the answer.
+  class InputSuspended : public std::runtime_error {
+  public:
+    InputSuspended(): runtime_error("Waiting for input.") { }
+  };
+
   Value dispatch_to_universe(std::string message);
+  // Load the Universe from in, send 'UPDATE' -> main with the given input, save it
+  // to out, and return the output.  If the turn asks for more input than it was
+  // given, what it has done so far is returned and the turn is saved as suspended;
+  // the next update's input answers it.
   std::string update_universe(Storage& in, Storage& out, std::string input, int width = 0);
   
 }
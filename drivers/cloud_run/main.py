@@ -21,7 +21,7 @@ def update(adventure: str):
         blob.download_to_filename(local_data)
         run = subprocess.run([
             '/usr/local/bin/archetype',
-            '--width=80', '--silent',
+            '--width=80', '--silent', '--max-time=2000',
             f'--update={local_data}',
             '--input={}'.format(command)], capture_output=True)
         narrative = run.stdout.decode()